@@ -0,0 +1,478 @@
+#include "assets.h"
+
+/*
+ * Font1206 stores two 12 bit columns in three bytes, the top row in the highest bit.
+ * Font0503 glyphs are 15 bits, one column of 5 rows after the other.
+ * The logo is mostly empty and run-length encoded: a zero byte is followed by the length of the run of zeros
+ * it stands for, every other byte is taken as it is.
+ */
+
+const unsigned char waveshare_logo_rle[WAVESHARE_LOGO_RLE_BYTES] =
+{
+    0X00,0X30,0X41,0X83,0X0C,0X30,0X33,0XF1,0XF8,0XC1,0X81,0X81,0XFC,0X7E,0X61,0XC2,
+    0X0E,0X10,0X33,0X03,0X00,0X01,0XC1,0X83,0X81,0X8C,0X60,0X61,0XC2,0X1A,0X18,0X23,
+    0X03,0X00,0X01,0XC1,0X82,0XC1,0X84,0X60,0X63,0X46,0X12,0X18,0X63,0X03,0X00,0X01,
+    0XC1,0X82,0X41,0X84,0X60,0X23,0X46,0X33,0X08,0X43,0X01,0X80,0XC1,0X86,0X61,0X8C,
+    0X60,0X32,0X64,0X31,0X0C,0XC3,0XF0,0XE0,0XFF,0X84,0X61,0XF8,0X7E,0X32,0X64,0X21,
+    0X8C,0XC3,0X00,0X01,0X30,0XC1,0X8C,0X21,0XF0,0X60,0X16,0X2C,0X7F,0X84,0X83,0X00,
+    0X01,0X18,0XC1,0X8F,0XF1,0X98,0X60,0X1C,0X3C,0X7F,0X87,0X83,0X00,0X01,0X18,0XC1,
+    0X8F,0XF1,0X8C,0X60,0X1C,0X38,0XC0,0XC7,0X83,0X02,0X18,0XC1,0X98,0X11,0X86,0X60,
+    0X0C,0X18,0XC0,0XC3,0X03,0XF3,0XF0,0XC1,0X98,0X19,0X86,0X7E,0X08,0X18,0X80,0X43,
+    0X03,0XF0,0XE0,0XC1,0X90,0X09,0X02,0X7E,0X00,0XA3,0X3E,0X00,0X01,0X1F,0XFF,0XFF,
+    0X3F,0X76,0XE0,0X7F,0XFF,0XFE,0X3F,0XFF,0XFE,0X1F,0XFF,0XFF,0X3F,0X76,0XF0,0X7F,
+    0XFF,0XFE,0X3F,0XFF,0XFE,0X1F,0XFF,0XFF,0X3B,0X76,0XFC,0X7F,0XFF,0XFE,0X3F,0XFF,
+    0XFE,0X1F,0XFF,0XFF,0XFB,0X77,0XFC,0X00,0X01,0X3C,0X00,0X01,0X3F,0XFF,0XFE,0X00,
+    0X02,0X3F,0XF3,0X77,0XFC,0X7F,0XFF,0XFE,0X3F,0XFF,0XFE,0X00,0X02,0X3E,0XF3,0X77,
+    0XC0,0X7F,0XFF,0XFE,0X3C,0X3E,0X1E,0X00,0X02,0X7C,0X73,0XFE,0X00,0X01,0X7F,0XFF,
+    0XFE,0X3C,0X3E,0X1E,0X00,0X02,0X7C,0X3F,0XFE,0X1C,0X70,0X3C,0X0E,0X3C,0X3E,0X1E,
+    0X00,0X02,0XF8,0X3F,0XFE,0XDC,0X77,0X3C,0XEE,0X3C,0X3E,0X1E,0X01,0XFF,0XF0,0X7B,
+    0XFD,0XF8,0X77,0XFF,0XEE,0X3F,0XFF,0XFE,0X01,0XFF,0XF0,0XF8,0X01,0XF8,0X73,0XBD,
+    0XCE,0X3F,0XFF,0XFE,0X01,0XFF,0XE0,0XFB,0XFC,0XF8,0X71,0XBD,0X8E,0X3F,0XFF,0XFE,
+    0X00,0X01,0X01,0XE0,0XF3,0XFE,0XF8,0X73,0XBF,0XCE,0X3F,0XFF,0XFE,0X00,0X01,0X01,
+    0XE0,0XF3,0XFE,0XF8,0X7F,0XBF,0XEE,0X3C,0X3E,0X1E,0X00,0X01,0X01,0XE0,0X72,0X04,
+    0XF0,0X00,0X03,0X3C,0X3E,0X1E,0X3F,0XFF,0XFF,0X70,0X00,0X01,0XF0,0X7F,0XFF,0XFE,
+    0X3C,0X3E,0X1E,0X3F,0XFF,0XFF,0X71,0XF8,0X70,0X7F,0XFF,0XFE,0X3C,0X3E,0X1E,0X3F,
+    0XFF,0XFF,0X71,0XFC,0X70,0X7F,0XFF,0XFE,0X3C,0X3E,0X1E,0X3F,0XFF,0XFF,0X71,0XFC,
+    0X70,0X00,0X02,0X1E,0X3F,0XFF,0XFE,0X00,0X01,0X01,0XE0,0X71,0XDC,0XF0,0X00,0X02,
+    0X1E,0X3F,0XFF,0XFE,0X00,0X01,0X01,0XE0,0X71,0XDC,0XF8,0X7F,0XFF,0XFE,0X3F,0XFF,
+    0XFE,0X00,0X01,0X01,0XE0,0X71,0XDC,0XF8,0X7F,0XFF,0XFE,0X3F,0XFF,0XFE,0X00,0X01,
+    0X01,0XE0,0X71,0XDC,0XF8,0X7F,0XFF,0XFE,0X00,0X01,0X3E,0X00,0X02,0X01,0XE0,0X71,
+    0XDD,0XF8,0X00,0X02,0X1E,0X00,0X01,0X3F,0XFF,0X0F,0XFF,0XE0,0X73,0XDF,0XFC,0X00,
+    0X02,0X1E,0X00,0X01,0X3F,0XFF,0X0F,0XFF,0XE0,0X77,0XDF,0XFC,0X7F,0XFF,0XFE,0X00,
+    0X01,0X3F,0XFF,0X0F,0XFF,0XE0,0X73,0X9F,0XDC,0X7F,0XFF,0XFE,0X00,0X01,0X3F,0XFF,
+    0X0F,0XFF,0XC0,0X70,0X00,0X01,0X08,0X7F,0XFF,0XFE,0X00,0XFF,0X00,0X4F,
+};
+
+/**
+ * Unpack the logo into `logo`, WAVESHARE_LOGO_BYTES bytes.
+ */
+void waveshare_logo_unpack(unsigned char *logo)
+{
+	const unsigned char *rle = waveshare_logo_rle, *end = rle + WAVESHARE_LOGO_RLE_BYTES;
+
+	while (rle < end) {
+		if (*rle) {
+			*logo++ = *rle++;
+		} else {
+			for (int n = rle[1]; n > 0; n--) *logo++ = 0;
+			rle += 2;
+		}
+	}
+}
+
+const unsigned char Font1206[95][FONT1206_GLYPH_BYTES] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*" ",0*/
+    {0x00,0x00,0x00,0x3F,0x40,0x00,0x00,0x00,0x00},/*"!",1*/
+    {0x00,0x03,0x00,0x40,0x03,0x00,0x40,0x00,0x00},/*""",2*/
+    {0x09,0x00,0xBC,0x3D,0x00,0xBC,0x3D,0x00,0x90},/*"#",3*/
+    {0x18,0xC2,0x44,0x7F,0xE2,0x24,0x31,0x80,0x00},/*"$",4*/
+    {0x18,0x02,0x4C,0x1B,0x00,0xD8,0x32,0x40,0x18},/*"%",5*/
+    {0x03,0x81,0xC4,0x27,0x41,0xC8,0x07,0x40,0x04},/*"&",6*/
+    {0x10,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"'",7*/
+    {0x00,0x00,0x00,0x00,0x01,0xF8,0x20,0x44,0x02},/*"(",8*/
+    {0x00,0x04,0x02,0x20,0x41,0xF8,0x00,0x00,0x00},/*")",9*/
+    {0x09,0x00,0x60,0x1F,0x80,0x60,0x09,0x00,0x00},/*"*",10*/
+    {0x04,0x00,0x40,0x3F,0x80,0x40,0x04,0x00,0x00},/*"+",11*/
+    {0x00,0x10,0x06,0x00,0x00,0x00,0x00,0x00,0x00},/*",",12*/
+    {0x04,0x00,0x40,0x04,0x00,0x40,0x04,0x00,0x00},/*"-",13*/
+    {0x00,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00},/*".",14*/
+    {0x00,0x20,0x1C,0x06,0x03,0x80,0x40,0x00,0x00},/*"/",15*/
+    {0x1F,0x82,0x04,0x20,0x42,0x04,0x1F,0x80,0x00},/*"0",16*/
+    {0x00,0x01,0x04,0x3F,0xC0,0x04,0x00,0x00,0x00},/*"1",17*/
+    {0x18,0xC2,0x14,0x22,0x42,0x44,0x18,0x40,0x00},/*"2",18*/
+    {0x10,0x82,0x04,0x24,0x42,0x44,0x1B,0x80,0x00},/*"3",19*/
+    {0x02,0x00,0xD0,0x11,0x03,0xFC,0x01,0x40,0x00},/*"4",20*/
+    {0x3C,0x82,0x44,0x24,0x42,0x44,0x23,0x80,0x00},/*"5",21*/
+    {0x1F,0x82,0x44,0x24,0x43,0x44,0x03,0x80,0x00},/*"6",22*/
+    {0x30,0x02,0x00,0x27,0xC3,0x80,0x20,0x00,0x00},/*"7",23*/
+    {0x1B,0x82,0x44,0x24,0x42,0x44,0x1B,0x80,0x00},/*"8",24*/
+    {0x1C,0x02,0x2C,0x22,0x42,0x24,0x1F,0x80,0x00},/*"9",25*/
+    {0x00,0x00,0x00,0x08,0x40,0x00,0x00,0x00,0x00},/*":",26*/
+    {0x00,0x00,0x00,0x04,0x60,0x00,0x00,0x00,0x00},/*";",27*/
+    {0x00,0x00,0x40,0x0A,0x01,0x10,0x20,0x84,0x04},/*"<",28*/
+    {0x09,0x00,0x90,0x09,0x00,0x90,0x09,0x00,0x00},/*"=",29*/
+    {0x00,0x04,0x04,0x20,0x81,0x10,0x0A,0x00,0x40},/*">",30*/
+    {0x18,0x02,0x00,0x23,0x42,0x40,0x18,0x00,0x00},/*"?",31*/
+    {0x1F,0x82,0x04,0x27,0x42,0x94,0x1F,0x40,0x00},/*"@",32*/
+    {0x00,0x40,0x7C,0x39,0x00,0xF0,0x01,0xC0,0x04},/*"A",33*/
+    {0x20,0x43,0xFC,0x24,0x42,0x44,0x1B,0x80,0x00},/*"B",34*/
+    {0x1F,0x82,0x04,0x20,0x42,0x04,0x30,0x80,0x00},/*"C",35*/
+    {0x20,0x43,0xFC,0x20,0x42,0x04,0x1F,0x80,0x00},/*"D",36*/
+    {0x20,0x43,0xFC,0x24,0x42,0xE4,0x30,0xC0,0x00},/*"E",37*/
+    {0x20,0x43,0xFC,0x24,0x42,0xE0,0x30,0x00,0x00},/*"F",38*/
+    {0x0F,0x01,0x08,0x20,0x42,0x24,0x33,0x80,0x20},/*"G",39*/
+    {0x20,0x43,0xFC,0x04,0x00,0x40,0x3F,0xC2,0x04},/*"H",40*/
+    {0x20,0x42,0x04,0x3F,0xC2,0x04,0x20,0x40,0x00},/*"I",41*/
+    {0x00,0x62,0x02,0x20,0x23,0xFC,0x20,0x02,0x00},/*"J",42*/
+    {0x20,0x43,0xFC,0x24,0x40,0xB0,0x30,0xC2,0x04},/*"K",43*/
+    {0x20,0x43,0xFC,0x20,0x40,0x04,0x00,0x40,0x0C},/*"L",44*/
+    {0x3F,0xC3,0xC0,0x03,0xC3,0xC0,0x3F,0xC0,0x00},/*"M",45*/
+    {0x20,0x43,0xFC,0x0C,0x42,0x30,0x3F,0xC2,0x00},/*"N",46*/
+    {0x1F,0x82,0x04,0x20,0x42,0x04,0x1F,0x80,0x00},/*"O",47*/
+    {0x20,0x43,0xFC,0x24,0x42,0x40,0x18,0x00,0x00},/*"P",48*/
+    {0x1F,0x82,0x14,0x21,0x42,0x0E,0x1F,0xA0,0x00},/*"Q",49*/
+    {0x20,0x43,0xFC,0x24,0x42,0x60,0x19,0xC0,0x04},/*"R",50*/
+    {0x18,0xC2,0x44,0x24,0x42,0x24,0x31,0x80,0x00},/*"S",51*/
+    {0x30,0x02,0x04,0x3F,0xC2,0x04,0x30,0x00,0x00},/*"T",52*/
+    {0x20,0x03,0xF8,0x00,0x40,0x04,0x3F,0x82,0x00},/*"U",53*/
+    {0x20,0x03,0xE0,0x01,0xC0,0x70,0x38,0x02,0x00},/*"V",54*/
+    {0x38,0x00,0x7C,0x3C,0x00,0x7C,0x38,0x00,0x00},/*"W",55*/
+    {0x20,0x43,0x9C,0x06,0x03,0x9C,0x20,0x40,0x00},/*"X",56*/
+    {0x20,0x03,0x84,0x07,0xC3,0x84,0x20,0x00,0x00},/*"Y",57*/
+    {0x30,0x42,0x1C,0x26,0x43,0x84,0x20,0xC0,0x00},/*"Z",58*/
+    {0x00,0x00,0x00,0x7F,0xE4,0x02,0x40,0x20,0x00},/*"[",59*/
+    {0x00,0x07,0x00,0x0C,0x00,0x38,0x00,0x40,0x00},/*"\",60*/
+    {0x00,0x04,0x02,0x40,0x27,0xFE,0x00,0x00,0x00},/*"]",61*/
+    {0x00,0x02,0x00,0x40,0x02,0x00,0x00,0x00,0x00},/*"^",62*/
+    {0x00,0x10,0x01,0x00,0x10,0x01,0x00,0x10,0x01},/*"_",63*/
+    {0x00,0x00,0x00,0x40,0x00,0x00,0x00,0x00,0x00},/*"`",64*/
+    {0x00,0x00,0x28,0x05,0x40,0x54,0x03,0xC0,0x04},/*"a",65*/
+    {0x20,0x03,0xFC,0x04,0x40,0x44,0x03,0x80,0x00},/*"b",66*/
+    {0x00,0x00,0x38,0x04,0x40,0x44,0x06,0x40,0x00},/*"c",67*/
+    {0x00,0x00,0x38,0x04,0x42,0x44,0x3F,0xC0,0x04},/*"d",68*/
+    {0x00,0x00,0x38,0x05,0x40,0x54,0x03,0x40,0x00},/*"e",69*/
+    {0x00,0x00,0x44,0x1F,0xC2,0x44,0x24,0x42,0x00},/*"f",70*/
+    {0x00,0x00,0x2E,0x05,0x50,0x55,0x06,0x50,0x42},/*"g",71*/
+    {0x20,0x43,0xFC,0x04,0x40,0x40,0x03,0xC0,0x04},/*"h",72*/
+    {0x00,0x00,0x44,0x27,0xC0,0x04,0x00,0x00,0x00},/*"i",73*/
+    {0x00,0x10,0x01,0x04,0x12,0x7E,0x00,0x00,0x00},/*"j",74*/
+    {0x20,0x43,0xFC,0x01,0x40,0x70,0x04,0xC0,0x44},/*"k",75*/
+    {0x20,0x42,0x04,0x3F,0xC0,0x04,0x00,0x40,0x00},/*"l",76*/
+    {0x07,0xC0,0x40,0x07,0xC0,0x40,0x03,0xC0,0x00},/*"m",77*/
+    {0x04,0x40,0x7C,0x04,0x40,0x40,0x03,0xC0,0x04},/*"n",78*/
+    {0x00,0x00,0x38,0x04,0x40,0x44,0x03,0x80,0x00},/*"o",79*/
+    {0x04,0x10,0x7F,0x04,0x50,0x44,0x03,0x80,0x00},/*"p",80*/
+    {0x00,0x00,0x38,0x04,0x40,0x45,0x07,0xF0,0x01},/*"q",81*/
+    {0x04,0x40,0x7C,0x02,0x40,0x40,0x04,0x00,0x00},/*"r",82*/
+    {0x00,0x00,0x64,0x05,0x40,0x54,0x04,0xC0,0x00},/*"s",83*/
+    {0x00,0x00,0x40,0x1F,0x80,0x44,0x00,0x40,0x00},/*"t",84*/
+    {0x04,0x00,0x78,0x00,0x40,0x44,0x07,0xC0,0x04},/*"u",85*/
+    {0x04,0x00,0x70,0x04,0xC0,0x18,0x06,0x00,0x40},/*"v",86*/
+    {0x06,0x00,0x1C,0x07,0x00,0x1C,0x06,0x00,0x00},/*"w",87*/
+    {0x04,0x40,0x6C,0x01,0x00,0x6C,0x04,0x40,0x00},/*"x",88*/
+    {0x04,0x10,0x71,0x04,0xE0,0x18,0x06,0x00,0x40},/*"y",89*/
+    {0x00,0x00,0x44,0x05,0xC0,0x64,0x04,0x40,0x00},/*"z",90*/
+    {0x00,0x00,0x00,0x04,0x07,0xBE,0x40,0x20,0x00},/*"{",91*/
+    {0x00,0x00,0x00,0x00,0x0F,0xFF,0x00,0x00,0x00},/*"|",92*/
+    {0x00,0x04,0x02,0x7B,0xE0,0x40,0x00,0x00,0x00},/*"}",93*/
+    {0x40,0x08,0x00,0x40,0x02,0x00,0x20,0x04,0x00},/*"~",94*/
+};
+
+const unsigned char Font1608[95][16] = {      
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*" ",0*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0xCC,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,0x00},/*"!",1*/
+    {0x00,0x00,0x08,0x00,0x30,0x00,0x60,0x00,0x08,0x00,0x30,0x00,0x60,0x00,0x00,0x00},/*""",2*/
+    {0x02,0x20,0x03,0xFC,0x1E,0x20,0x02,0x20,0x03,0xFC,0x1E,0x20,0x02,0x20,0x00,0x00},/*"#",3*/
+    {0x00,0x00,0x0E,0x18,0x11,0x04,0x3F,0xFF,0x10,0x84,0x0C,0x78,0x00,0x00,0x00,0x00},/*"$",4*/
+    {0x0F,0x00,0x10,0x84,0x0F,0x38,0x00,0xC0,0x07,0x78,0x18,0x84,0x00,0x78,0x00,0x00},/*"%",5*/
+    {0x00,0x78,0x0F,0x84,0x10,0xC4,0x11,0x24,0x0E,0x98,0x00,0xE4,0x00,0x84,0x00,0x08},/*"&",6*/
+    {0x08,0x00,0x68,0x00,0x70,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"'",7*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x07,0xE0,0x18,0x18,0x20,0x04,0x40,0x02,0x00,0x00},/*"(",8*/
+    {0x00,0x00,0x40,0x02,0x20,0x04,0x18,0x18,0x07,0xE0,0x00,0x00,0x00,0x00,0x00,0x00},/*")",9*/
+    {0x02,0x40,0x02,0x40,0x01,0x80,0x0F,0xF0,0x01,0x80,0x02,0x40,0x02,0x40,0x00,0x00},/*"*",10*/
+    {0x00,0x80,0x00,0x80,0x00,0x80,0x0F,0xF8,0x00,0x80,0x00,0x80,0x00,0x80,0x00,0x00},/*"+",11*/
+    {0x00,0x01,0x00,0x0D,0x00,0x0E,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*",",12*/
+    {0x00,0x00,0x00,0x80,0x00,0x80,0x00,0x80,0x00,0x80,0x00,0x80,0x00,0x80,0x00,0x80},/*"-",13*/
+    {0x00,0x00,0x00,0x0C,0x00,0x0C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*".",14*/
+    {0x00,0x00,0x00,0x06,0x00,0x18,0x00,0x60,0x01,0x80,0x06,0x00,0x18,0x00,0x20,0x00},/*"/",15*/
+    {0x00,0x00,0x07,0xF0,0x08,0x08,0x10,0x04,0x10,0x04,0x08,0x08,0x07,0xF0,0x00,0x00},/*"0",16*/
+    {0x00,0x00,0x08,0x04,0x08,0x04,0x1F,0xFC,0x00,0x04,0x00,0x04,0x00,0x00,0x00,0x00},/*"1",17*/
+    {0x00,0x00,0x0E,0x0C,0x10,0x14,0x10,0x24,0x10,0x44,0x11,0x84,0x0E,0x0C,0x00,0x00},/*"2",18*/
+    {0x00,0x00,0x0C,0x18,0x10,0x04,0x11,0x04,0x11,0x04,0x12,0x88,0x0C,0x70,0x00,0x00},/*"3",19*/
+    {0x00,0x00,0x00,0xE0,0x03,0x20,0x04,0x24,0x08,0x24,0x1F,0xFC,0x00,0x24,0x00,0x00},/*"4",20*/
+    {0x00,0x00,0x1F,0x98,0x10,0x84,0x11,0x04,0x11,0x04,0x10,0x88,0x10,0x70,0x00,0x00},/*"5",21*/
+    {0x00,0x00,0x07,0xF0,0x08,0x88,0x11,0x04,0x11,0x04,0x18,0x88,0x00,0x70,0x00,0x00},/*"6",22*/
+    {0x00,0x00,0x1C,0x00,0x10,0x00,0x10,0xFC,0x13,0x00,0x1C,0x00,0x10,0x00,0x00,0x00},/*"7",23*/
+    {0x00,0x00,0x0E,0x38,0x11,0x44,0x10,0x84,0x10,0x84,0x11,0x44,0x0E,0x38,0x00,0x00},/*"8",24*/
+    {0x00,0x00,0x07,0x00,0x08,0x8C,0x10,0x44,0x10,0x44,0x08,0x88,0x07,0xF0,0x00,0x00},/*"9",25*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x0C,0x03,0x0C,0x00,0x00,0x00,0x00,0x00,0x00},/*":",26*/
+    {0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*";",27*/
+    {0x00,0x00,0x00,0x80,0x01,0x40,0x02,0x20,0x04,0x10,0x08,0x08,0x10,0x04,0x00,0x00},/*"<",28*/
+    {0x02,0x20,0x02,0x20,0x02,0x20,0x02,0x20,0x02,0x20,0x02,0x20,0x02,0x20,0x00,0x00},/*"=",29*/
+    {0x00,0x00,0x10,0x04,0x08,0x08,0x04,0x10,0x02,0x20,0x01,0x40,0x00,0x80,0x00,0x00},/*">",30*/
+    {0x00,0x00,0x0E,0x00,0x12,0x00,0x10,0x0C,0x10,0x6C,0x10,0x80,0x0F,0x00,0x00,0x00},/*"?",31*/
+    {0x03,0xE0,0x0C,0x18,0x13,0xE4,0x14,0x24,0x17,0xC4,0x08,0x28,0x07,0xD0,0x00,0x00},/*"@",32*/
+    {0x00,0x04,0x00,0x3C,0x03,0xC4,0x1C,0x40,0x07,0x40,0x00,0xE4,0x00,0x1C,0x00,0x04},/*"A",33*/
+    {0x10,0x04,0x1F,0xFC,0x11,0x04,0x11,0x04,0x11,0x04,0x0E,0x88,0x00,0x70,0x00,0x00},/*"B",34*/
+    {0x03,0xE0,0x0C,0x18,0x10,0x04,0x10,0x04,0x10,0x04,0x10,0x08,0x1C,0x10,0x00,0x00},/*"C",35*/
+    {0x10,0x04,0x1F,0xFC,0x10,0x04,0x10,0x04,0x10,0x04,0x08,0x08,0x07,0xF0,0x00,0x00},/*"D",36*/
+    {0x10,0x04,0x1F,0xFC,0x11,0x04,0x11,0x04,0x17,0xC4,0x10,0x04,0x08,0x18,0x00,0x00},/*"E",37*/
+    {0x10,0x04,0x1F,0xFC,0x11,0x04,0x11,0x00,0x17,0xC0,0x10,0x00,0x08,0x00,0x00,0x00},/*"F",38*/
+    {0x03,0xE0,0x0C,0x18,0x10,0x04,0x10,0x04,0x10,0x44,0x1C,0x78,0x00,0x40,0x00,0x00},/*"G",39*/
+    {0x10,0x04,0x1F,0xFC,0x10,0x84,0x00,0x80,0x00,0x80,0x10,0x84,0x1F,0xFC,0x10,0x04},/*"H",40*/
+    {0x00,0x00,0x10,0x04,0x10,0x04,0x1F,0xFC,0x10,0x04,0x10,0x04,0x00,0x00,0x00,0x00},/*"I",41*/
+    {0x00,0x03,0x00,0x01,0x10,0x01,0x10,0x01,0x1F,0xFE,0x10,0x00,0x10,0x00,0x00,0x00},/*"J",42*/
+    {0x10,0x04,0x1F,0xFC,0x11,0x04,0x03,0x80,0x14,0x64,0x18,0x1C,0x10,0x04,0x00,0x00},/*"K",43*/
+    {0x10,0x04,0x1F,0xFC,0x10,0x04,0x00,0x04,0x00,0x04,0x00,0x04,0x00,0x0C,0x00,0x00},/*"L",44*/
+    {0x10,0x04,0x1F,0xFC,0x1F,0x00,0x00,0xFC,0x1F,0x00,0x1F,0xFC,0x10,0x04,0x00,0x00},/*"M",45*/
+    {0x10,0x04,0x1F,0xFC,0x0C,0x04,0x03,0x00,0x00,0xE0,0x10,0x18,0x1F,0xFC,0x10,0x00},/*"N",46*/
+    {0x07,0xF0,0x08,0x08,0x10,0x04,0x10,0x04,0x10,0x04,0x08,0x08,0x07,0xF0,0x00,0x00},/*"O",47*/
+    {0x10,0x04,0x1F,0xFC,0x10,0x84,0x10,0x80,0x10,0x80,0x10,0x80,0x0F,0x00,0x00,0x00},/*"P",48*/
+    {0x07,0xF0,0x08,0x18,0x10,0x24,0x10,0x24,0x10,0x1C,0x08,0x0A,0x07,0xF2,0x00,0x00},/*"Q",49*/
+    {0x10,0x04,0x1F,0xFC,0x11,0x04,0x11,0x00,0x11,0xC0,0x11,0x30,0x0E,0x0C,0x00,0x04},/*"R",50*/
+    {0x00,0x00,0x0E,0x1C,0x11,0x04,0x10,0x84,0x10,0x84,0x10,0x44,0x1C,0x38,0x00,0x00},/*"S",51*/
+    {0x18,0x00,0x10,0x00,0x10,0x04,0x1F,0xFC,0x10,0x04,0x10,0x00,0x18,0x00,0x00,0x00},/*"T",52*/
+    {0x10,0x00,0x1F,0xF8,0x10,0x04,0x00,0x04,0x00,0x04,0x10,0x04,0x1F,0xF8,0x10,0x00},/*"U",53*/
+    {0x10,0x00,0x1E,0x00,0x11,0xE0,0x00,0x1C,0x00,0x70,0x13,0x80,0x1C,0x00,0x10,0x00},/*"V",54*/
+    {0x1F,0xC0,0x10,0x3C,0x00,0xE0,0x1F,0x00,0x00,0xE0,0x10,0x3C,0x1F,0xC0,0x00,0x00},/*"W",55*/
+    {0x10,0x04,0x18,0x0C,0x16,0x34,0x01,0xC0,0x01,0xC0,0x16,0x34,0x18,0x0C,0x10,0x04},/*"X",56*/
+    {0x10,0x00,0x1C,0x00,0x13,0x04,0x00,0xFC,0x13,0x04,0x1C,0x00,0x10,0x00,0x00,0x00},/*"Y",57*/
+    {0x08,0x04,0x10,0x1C,0x10,0x64,0x10,0x84,0x13,0x04,0x1C,0x04,0x10,0x18,0x00,0x00},/*"Z",58*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0xFE,0x40,0x02,0x40,0x02,0x40,0x02,0x00,0x00},/*"[",59*/
+    {0x00,0x00,0x30,0x00,0x0C,0x00,0x03,0x80,0x00,0x60,0x00,0x1C,0x00,0x03,0x00,0x00},/*"\",60*/
+    {0x00,0x00,0x40,0x02,0x40,0x02,0x40,0x02,0x7F,0xFE,0x00,0x00,0x00,0x00,0x00,0x00},/*"]",61*/
+    {0x00,0x00,0x00,0x00,0x20,0x00,0x40,0x00,0x40,0x00,0x40,0x00,0x20,0x00,0x00,0x00},/*"^",62*/
+    {0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01,0x00,0x01},/*"_",63*/
+    {0x00,0x00,0x40,0x00,0x40,0x00,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"`",64*/
+    {0x00,0x00,0x00,0x98,0x01,0x24,0x01,0x44,0x01,0x44,0x01,0x44,0x00,0xFC,0x00,0x04},/*"a",65*/
+    {0x10,0x00,0x1F,0xFC,0x00,0x88,0x01,0x04,0x01,0x04,0x00,0x88,0x00,0x70,0x00,0x00},/*"b",66*/
+    {0x00,0x00,0x00,0x70,0x00,0x88,0x01,0x04,0x01,0x04,0x01,0x04,0x00,0x88,0x00,0x00},/*"c",67*/
+    {0x00,0x00,0x00,0x70,0x00,0x88,0x01,0x04,0x01,0x04,0x11,0x08,0x1F,0xFC,0x00,0x04},/*"d",68*/
+    {0x00,0x00,0x00,0xF8,0x01,0x44,0x01,0x44,0x01,0x44,0x01,0x44,0x00,0xC8,0x00,0x00},/*"e",69*/
+    {0x00,0x00,0x01,0x04,0x01,0x04,0x0F,0xFC,0x11,0x04,0x11,0x04,0x11,0x00,0x18,0x00},/*"f",70*/
+    {0x00,0x00,0x00,0xD6,0x01,0x29,0x01,0x29,0x01,0x29,0x01,0xC9,0x01,0x06,0x00,0x00},/*"g",71*/
+    {0x10,0x04,0x1F,0xFC,0x00,0x84,0x01,0x00,0x01,0x00,0x01,0x04,0x00,0xFC,0x00,0x04},/*"h",72*/
+    {0x00,0x00,0x01,0x04,0x19,0x04,0x19,0xFC,0x00,0x04,0x00,0x04,0x00,0x00,0x00,0x00},/*"i",73*/
+    {0x00,0x00,0x00,0x03,0x00,0x01,0x01,0x01,0x19,0x01,0x19,0xFE,0x00,0x00,0x00,0x00},/*"j",74*/
+    {0x10,0x04,0x1F,0xFC,0x00,0x24,0x00,0x40,0x01,0xB4,0x01,0x0C,0x01,0x04,0x00,0x00},/*"k",75*/
+    {0x00,0x00,0x10,0x04,0x10,0x04,0x1F,0xFC,0x00,0x04,0x00,0x04,0x00,0x00,0x00,0x00},/*"l",76*/
+    {0x01,0x04,0x01,0xFC,0x01,0x04,0x01,0x00,0x01,0xFC,0x01,0x04,0x01,0x00,0x00,0xFC},/*"m",77*/
+    {0x01,0x04,0x01,0xFC,0x00,0x84,0x01,0x00,0x01,0x00,0x01,0x04,0x00,0xFC,0x00,0x04},/*"n",78*/
+    {0x00,0x00,0x00,0xF8,0x01,0x04,0x01,0x04,0x01,0x04,0x01,0x04,0x00,0xF8,0x00,0x00},/*"o",79*/
+    {0x01,0x01,0x01,0xFF,0x00,0x85,0x01,0x04,0x01,0x04,0x00,0x88,0x00,0x70,0x00,0x00},/*"p",80*/
+    {0x00,0x00,0x00,0x70,0x00,0x88,0x01,0x04,0x01,0x04,0x01,0x05,0x01,0xFF,0x00,0x01},/*"q",81*/
+    {0x01,0x04,0x01,0x04,0x01,0xFC,0x00,0x84,0x01,0x04,0x01,0x00,0x01,0x80,0x00,0x00},/*"r",82*/
+    {0x00,0x00,0x00,0xCC,0x01,0x24,0x01,0x24,0x01,0x24,0x01,0x24,0x01,0x98,0x00,0x00},/*"s",83*/
+    {0x00,0x00,0x01,0x00,0x01,0x00,0x07,0xF8,0x01,0x04,0x01,0x04,0x00,0x00,0x00,0x00},/*"t",84*/
+    {0x01,0x00,0x01,0xF8,0x00,0x04,0x00,0x04,0x00,0x04,0x01,0x08,0x01,0xFC,0x00,0x04},/*"u",85*/
+    {0x01,0x00,0x01,0x80,0x01,0x70,0x00,0x0C,0x00,0x10,0x01,0x60,0x01,0x80,0x01,0x00},/*"v",86*/
+    {0x01,0xF0,0x01,0x0C,0x00,0x30,0x01,0xC0,0x00,0x30,0x01,0x0C,0x01,0xF0,0x01,0x00},/*"w",87*/
+    {0x00,0x00,0x01,0x04,0x01,0x8C,0x00,0x74,0x01,0x70,0x01,0x8C,0x01,0x04,0x00,0x00},/*"x",88*/
+    {0x01,0x01,0x01,0x81,0x01,0x71,0x00,0x0E,0x00,0x18,0x01,0x60,0x01,0x80,0x01,0x00},/*"y",89*/
+    {0x00,0x00,0x01,0x84,0x01,0x0C,0x01,0x34,0x01,0x44,0x01,0x84,0x01,0x0C,0x00,0x00},/*"z",90*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x3E,0xFC,0x40,0x02,0x40,0x02},/*"{",91*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,0x00,0x00,0x00,0x00,0x00},/*"|",92*/
+    {0x00,0x00,0x40,0x02,0x40,0x02,0x3E,0xFC,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"}",93*/
+    {0x00,0x00,0x60,0x00,0x80,0x00,0x80,0x00,0x40,0x00,0x40,0x00,0x20,0x00,0x20,0x00},/*"~",94*/
+};
+
+const unsigned char Font1612[11][32] = 
+{
+    {0x00,0x00,0x3F,0xFC,0x3F,0xFC,0x30,0x0C,0x30,0x0C,0x30,0x0C,0x30,0x0C,0x30,0x0C,
+    0x30,0x0C,0x30,0x0C,0x30,0x0C,0x30,0x0C,0x30,0x0C,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"0",0*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x30,0x00,
+    0x30,0x00,0x3F,0xFC,0x3F,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"1",1*/
+    {0x00,0x00,0x39,0xFC,0x39,0xFC,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x3F,0x8C,0x3F,0x8C,0x00,0x00},/*"2",2*/
+    {0x00,0x00,0x38,0x1C,0x38,0x1C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"3",3*/
+    {0x00,0x00,0x3F,0x80,0x3F,0x80,0x01,0x80,0x01,0x80,0x01,0x80,0x01,0x80,0x01,0x80,
+    0x01,0x80,0x01,0x80,0x01,0x80,0x01,0x80,0x01,0x80,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"4",4*/
+    {0x00,0x00,0x3F,0xBC,0x3F,0xBC,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0xFC,0x31,0xFC,0x00,0x00},/*"5",5*/
+    {0x00,0x00,0x3F,0x9C,0x3F,0x9C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0xFC,0x31,0xFC,0x00,0x00},/*"6",6*/
+    {0x00,0x00,0x38,0x00,0x38,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,
+    0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x30,0x00,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"7",7*/
+    {0x00,0x00,0x3F,0xFC,0x3F,0xFC,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"8",8*/
+    {0x00,0x00,0x3F,0x9C,0x3F,0x9C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,
+    0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x31,0x8C,0x3F,0xFC,0x3F,0xFC,0x00,0x00},/*"9",9*/
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x18,0x30,
+    0x18,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*":",10*/
+};
+
+const unsigned char Font3216[11][64] = 
+{
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,    /*"0",0*/
+    0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,
+    0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,0x30,0x00,0x00,0x0C,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,   /*"1",1*/
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3C,0x01,0xFF,0xFC,0x3C,0x01,0xFF,0xFC,   /*"2",2*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x3F,0xFF,0x80,0x0C,0x3F,0xFF,0x80,0x0C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x00,0x00,0x3C,0x38,0x00,0x00,0x3C,   /*"3",3*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0x80,0x00,0x3F,0xFF,0x80,0x00,  /*"4",4*/
+    0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,
+    0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,0x00,0x01,0x80,0x00,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0x80,0x3C,0x3F,0xFF,0x80,0x3C,  /*"5",5*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0xFF,0xFC,0x30,0x01,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,  /*"6",6*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x3C,0x01,0xFF,0xFC,0x3C,0x01,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+        
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3C,0x00,0x00,0x00,0x3C,0x00,0x00,0x00,  /*"7",7*/
+    0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,
+    0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x30,0x00,0x00,0x00,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},    
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,  /*"8",8*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xFF,0x80,0x3C,0x3F,0xFF,0x80,0x3C,  /*"9",9*/
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,0x30,0x01,0x80,0x0C,
+    0x3F,0xFF,0xFF,0xFC,0x3F,0xFF,0xFF,0xFC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,  /*":",10*/
+    0x00,0x00,0x00,0x00,0x0F,0xF0,0x0F,0xF0,0x0F,0xF0,0x0F,0xF0,0x0C,0x00,0x00,0x30,
+    0x0C,0x00,0x00,0x30,0x0F,0xF0,0x0F,0xF0,0x0F,0xF0,0x0F,0xF0,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+};    
+
+const uint16_t Font0503[95] = {
+    0x0000,/*" ",0*/
+    0x0740,/*"!",1*/
+    0xC030,/*""",2*/
+    0xFABE,/*"#",3*/
+    0x66CC,/*"$",4*/
+    0x9932,/*"%",5*/
+    0x5556,/*"&",6*/
+    0x0060,/*"'",7*/
+    0x7440,/*"(",8*/
+    0x045C,/*")",9*/
+    0x5114,/*"*",10*/
+    0x2388,/*"+",11*/
+    0x00C0,/*",",12*/
+    0x0218,/*"-",13*/
+    0x0040,/*".",14*/
+    0x0BA0,/*"/",15*/
+    0x745C,/*"0",16*/
+    0x443E,/*"1",17*/
+    0xBD7A,/*"2",18*/
+    0x8D7E,/*"3",19*/
+    0xE11E,/*"4",20*/
+    0xED6E,/*"5",21*/
+    0xFD6E,/*"6",22*/
+    0x85F0,/*"7",23*/
+    0xFD7E,/*"8",24*/
+    0xE53E,/*"9",25*/
+    0x0280,/*":",26*/
+    0x0A80,/*";",27*/
+    0x22A2,/*"<",28*/
+    0x5294,/*"=",29*/
+    0x8A88,/*">",30*/
+    0x8578,/*"?",31*/
+    0xFC7A,/*"@",32*/
+    0x7D1E,/*"A",33*/
+    0xFD76,/*"B",34*/
+    0xFC62,/*"C",35*/
+    0xFC5C,/*"D",36*/
+    0xFD6A,/*"E",37*/
+    0xFD28,/*"F",38*/
+    0xFC6E,/*"G",39*/
+    0xF93E,/*"H",40*/
+    0x07C0,/*"I",41*/
+    0x107C,/*"J",42*/
+    0xF936,/*"K",43*/
+    0xF842,/*"L",44*/
+    0xFA3E,/*"M",45*/
+    0xFC1E,/*"N",46*/
+    0xFC7E,/*"O",47*/
+    0xFD38,/*"P",48*/
+    0xF4BE,/*"Q",49*/
+    0xFD36,/*"R",50*/
+    0x4D64,/*"S",51*/
+    0x87E0,/*"T",52*/
+    0xF87E,/*"U",53*/
+    0xF07C,/*"V",54*/
+    0xF8BE,/*"W",55*/
+    0xD936,/*"X",56*/
+    0xC1F0,/*"Y",57*/
+    0x9D72,/*"Z",58*/
+    0xFC40,/*"[",59*/
+    0x8382,/*"\",60*/
+    0x047E,/*"]",61*/
+    0x4410,/*"^",62*/
+    0x0842,/*"_",63*/
+    0x0820,/*"`",64*/
+    0x7D1E,/*"A",33*/
+    0xFD76,/*"B",34*/
+    0xFC62,/*"C",35*/
+    0xFC5C,/*"D",36*/
+    0xFD6A,/*"E",37*/
+    0xFD28,/*"F",38*/
+    0xFC6E,/*"G",39*/
+    0xF93E,/*"H",40*/
+    0x07C0,/*"I",41*/
+    0x107C,/*"J",42*/
+    0xF936,/*"K",43*/
+    0xF842,/*"L",44*/
+    0xFA3E,/*"M",45*/
+    0xFC1E,/*"N",46*/
+    0xFC7E,/*"O",47*/
+    0xFD38,/*"P",48*/
+    0xF4BE,/*"Q",49*/
+    0xFD36,/*"R",50*/
+    0x4D64,/*"S",51*/
+    0x87E0,/*"T",52*/
+    0xF87E,/*"U",53*/
+    0xF07C,/*"V",54*/
+    0xF8BE,/*"W",55*/
+    0xD936,/*"X",56*/
+    0xC1F0,/*"Y",57*/
+    0x9D72,/*"Z",58*/
+    0x26E2,/*"{",91*/
+    0x07C0,/*"|",92*/
+    0x8EC8,/*"}",93*/
+    0x3118,/*"~",94*/
+}; 
+
+const unsigned char Bmp4016[96] =  //SUN
+{
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0xF1,0x81,0x8F,0xFC,0x3F,
+    0xF1,0x81,0x8F,0xFC,0x30,0x31,0x81,0x8C,0x0C,0x30,0x01,0x81,0x8C,0x0C,0x30,0x01,
+    0x81,0x8C,0x0C,0x3F,0xF1,0x81,0x8C,0x0C,0x3F,0xF1,0x81,0x8C,0x0C,0x00,0x31,0x81,
+    0x8C,0x0C,0x00,0x31,0x81,0x8C,0x0C,0x30,0x31,0x81,0x8C,0x0C,0x3F,0xF1,0xFF,0x8C,
+    0x0C,0x3F,0xF1,0xFF,0x8C,0x0C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+};
+
+const unsigned char Signal816[16] = //mobie signal
+{
+    0xFE,0x02,0x92,0x0A,0x54,0x2A,0x38,0xAA,0x12,0xAA,0x12,0xAA,0x12,0xAA,0x12,0xAA
+};
+
+const unsigned char Msg816[16] =  //message
+{
+    0x1F,0xF8,0x10,0x08,0x18,0x18,0x14,0x28,0x13,0xC8,0x10,0x08,0x10,0x08,0x1F,0xF8
+};
+
+const unsigned char Bat816[16] = //batery
+{
+    0x0F,0xFE,0x30,0x02,0x26,0xDA,0x26,0xDA,0x26,0xDA,0x26,0xDA,0x30,0x02,0x0F,0xFE
+};
+
+const unsigned char Bluetooth88[8] = // bluetooth
+{
+    0x18,0x54,0x32,0x1C,0x1C,0x32,0x54,0x18
+};
+
+const unsigned char GPRS88[8] = //GPRS
+{
+    0xC3,0x99,0x24,0x20,0x2C,0x24,0x99,0xC3
+};
+
+const unsigned char Alarm88[8] = //alram
+{
+    0xC3,0xBD,0x42,0x52,0x4E,0x42,0x3C,0xC3
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef _ASSETS_H_
+#define _ASSETS_H_
+#include <stdint.h>
+
+/*
+ * Fonts and bitmaps of the display driver. They are defined once in assets.c, so a program carries
+ * a single copy however many of its files include ssd1331.h.
+ */
+
+#define FONT1206_GLYPH_BYTES 9  // 6 columns of 12 rows, packed without the 4 padding bits per column
+#define WAVESHARE_LOGO_BYTES 1024   // 128x64 bitmap once unpacked
+#define WAVESHARE_LOGO_RLE_BYTES 510  // as stored, run-length encoded
+
+extern const unsigned char waveshare_logo_rle[WAVESHARE_LOGO_RLE_BYTES];
+extern const unsigned char Font1206[95][FONT1206_GLYPH_BYTES];
+extern const unsigned char Font1608[95][16];
+extern const unsigned char Font1612[11][32];
+extern const unsigned char Font3216[11][64];
+extern const uint16_t Font0503[95];
+extern const unsigned char Bmp4016[96];
+extern const unsigned char Signal816[16];
+extern const unsigned char Msg816[16];
+extern const unsigned char Bat816[16];
+extern const unsigned char Bluetooth88[8];
+extern const unsigned char GPRS88[8];
+extern const unsigned char Alarm88[8];
+
+void waveshare_logo_unpack(unsigned char *);
+#endif
@@ -0,0 +1,107 @@
+#include <math.h>
+#include <string.h>
+#include "autoscale.h"
+
+#define SCALE_SHRINK_RATIO 0.5f
+
+/**
+ * Track the extremes of the latest `window` values, at most HISTORY_CAPACITY.
+ *
+ * @returns 1 on success, -1 if the window is out of range.
+ */
+int minmax_init(MINMAX_WINDOW *minmax, int window)
+{
+	if (window < 1 || window > HISTORY_CAPACITY) return -1;
+
+	memset(minmax, 0, sizeof *minmax);
+	minmax->window = window;
+	return 1;
+}
+
+/**
+ * Append `value` to a deque after dropping the entries it makes irrelevant from the back
+ * and the front entry if it leaves the window. Both happen before the new entry is written,
+ * so a full deque of `window` == HISTORY_CAPACITY entries does not overwrite its front.
+ * `keeps_before` tells if an older entry stays relevant next to the new value.
+ */
+static void deque_push(MINMAX_ENTRY *deque, int *head, int *cnt, int window, uint32_t seq, float value,
+		int (*keeps_before)(float, float))
+{
+	while (*cnt > 0 && !keeps_before(deque[(*head + *cnt - 1) % HISTORY_CAPACITY].value, value)) (*cnt)--;
+
+	if (*cnt > 0 && seq - deque[*head].seq >= (uint32_t) window) {
+		*head = (*head + 1) % HISTORY_CAPACITY;
+		(*cnt)--;
+	}
+
+	MINMAX_ENTRY *entry = &deque[(*head + *cnt) % HISTORY_CAPACITY];
+	entry->seq = seq;
+	entry->value = value;
+	(*cnt)++;
+}
+
+static int is_lower(float older, float newer) { return older < newer; }
+static int is_higher(float older, float newer) { return older > newer; }
+
+void minmax_push(MINMAX_WINDOW *minmax, float value)
+{
+	uint32_t seq = minmax->seq++;
+	deque_push(minmax->min, &minmax->min_head, &minmax->min_cnt, minmax->window, seq, value, is_lower);
+	deque_push(minmax->max, &minmax->max_head, &minmax->max_cnt, minmax->window, seq, value, is_higher);
+}
+
+/**
+ * @returns 1 if the extremes of the window were stored in `min` and `max`, 0 if no value was pushed yet.
+ */
+int minmax_get(const MINMAX_WINDOW *minmax, float *min, float *max)
+{
+	if (!minmax->min_cnt) return 0;
+	*min = minmax->min[minmax->min_head].value;
+	*max = minmax->max[minmax->max_head].value;
+	return 1;
+}
+
+void scale_init(SCALE *scale, float step, float min_span)
+{
+	memset(scale, 0, sizeof *scale);
+	scale->step = step;
+	scale->min_span = min_span;
+}
+
+/**
+ * Pin the scale to [lo, hi], scale_fit() leaves it alone from then on.
+ */
+void scale_fix(SCALE *scale, float lo, float hi)
+{
+	scale->lo = lo;
+	scale->hi = hi;
+	scale->valid = 1;
+	scale->fixed = 1;
+}
+
+/**
+ * Adapt the scale to values between `min` and `max`.
+ *
+ * @returns 1 if the range changed and values have to be mapped again, else 0.
+ */
+int scale_fit(SCALE *scale, float min, float max)
+{
+	if (scale->fixed) return 0;
+
+	float lo = floorf(min / scale->step) * scale->step;
+	float hi = ceilf(max / scale->step) * scale->step;
+	if (hi - lo < scale->min_span) {
+		/* Too flat to be worth the full height: center it, staying on the step grid */
+		lo = floorf(((lo + hi - scale->min_span) / 2) / scale->step) * scale->step;
+		hi = lo + ceilf(scale->min_span / scale->step) * scale->step;
+	}
+
+	if (scale->valid && min >= scale->lo && max <= scale->hi
+			&& hi - lo > (scale->hi - scale->lo) * SCALE_SHRINK_RATIO) return 0;
+	if (scale->valid && lo == scale->lo && hi == scale->hi) return 0;
+
+	scale->lo = lo;
+	scale->hi = hi;
+	scale->valid = 1;
+	return 1;
+}
@@ -0,0 +1,45 @@
+#ifndef _AUTOSCALE_H_
+#define _AUTOSCALE_H_
+#include <stdint.h>
+#include "history.h"
+
+/**
+ * A sample kept in a monotonic deque, identified by its position in the stream.
+ */
+typedef struct MINMAX_ENTRY {
+	uint32_t seq;
+	float value;
+} MINMAX_ENTRY;
+
+/**
+ * Minimum and maximum of the latest `window` values of a stream in O(1) amortized per value.
+ * Each deque only holds values that can still become the extreme once older ones leave the window:
+ * increasing values for the minimum, decreasing values for the maximum, the extreme at the front.
+ */
+typedef struct MINMAX_WINDOW {
+	int window;
+	uint32_t seq; // position of the next value
+	MINMAX_ENTRY min[HISTORY_CAPACITY], max[HISTORY_CAPACITY];
+	int min_head, min_cnt, max_head, max_cnt;
+} MINMAX_WINDOW;
+
+/**
+ * Value range of a chart axis. It grows as soon as a value leaves it, but only shrinks once the values
+ * need less than half of it, so the chart does not jump back and forth on every sample.
+ * Bounds are multiples of `step` and at least `min_span` apart.
+ */
+typedef struct SCALE {
+	float lo, hi;
+	float step, min_span;
+	int valid;
+	int fixed; // set by scale_fix, the range never changes
+} SCALE;
+
+int minmax_init(MINMAX_WINDOW *, int);
+void minmax_push(MINMAX_WINDOW *, float);
+int minmax_get(const MINMAX_WINDOW *, float *, float *);
+
+void scale_init(SCALE *, float, float);
+void scale_fix(SCALE *, float, float);
+int scale_fit(SCALE *, float, float);
+#endif
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "autoscale.h"
+
+/*
+ * Check of the sliding window extremes: pushes a rising ramp, a falling ramp and pseudo-random values
+ * through windows up to HISTORY_CAPACITY and compares every minimum and maximum with a scan of the
+ * latest `window` values. The ramps fill the deques up to the full window.
+ */
+
+#define CHECK_VALUES 1000
+
+static const int windows[] = { 1, 2, 47, HISTORY_CAPACITY - 1, HISTORY_CAPACITY };
+
+/**
+ * @returns the amount of values at which the window reported other extremes than a scan.
+ */
+static int check_window(int window)
+{
+	static float values[CHECK_VALUES];
+	MINMAX_WINDOW minmax;
+	int failures = 0;
+
+	if (minmax_init(&minmax, window) < 0) return 1;
+
+	srand(window);
+	for (int i = 0; i < CHECK_VALUES; i++) {
+		values[i] = i < 300 ? i : i < 600 ? 900 - i : rand() % 500;
+		minmax_push(&minmax, values[i]);
+
+		float min, max, expected_min = values[i], expected_max = values[i];
+		for (int j = i - window + 1 < 0 ? 0 : i - window + 1; j <= i; j++) {
+			if (values[j] < expected_min) expected_min = values[j];
+			if (values[j] > expected_max) expected_max = values[j];
+		}
+		if (!minmax_get(&minmax, &min, &max) || min != expected_min || max != expected_max) {
+			if (!failures) fprintf(stderr, "window %d, value %d: min %.0f max %.0f, expected %.0f %.0f\n",
+			                       window, i, min, max, expected_min, expected_max);
+			failures++;
+		}
+	}
+	return failures;
+}
+
+int main(void)
+{
+	int failures = 0;
+
+	for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+		failures += check_window(windows[i]);
+	}
+	printf("%s\n", failures ? "FAIL" : "OK");
+	return failures ? 1 : 0;
+}
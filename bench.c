@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <librdkafka/rdkafka.h>
+#include <librdkafka/rdkafka_mock.h>
+#include "timeops.h"
+
+/*
+ * Throughput harness: starts librdkafka's mock cluster, runs a display program built against
+ * the mock display backend (rpi-kafka-oled-mock, temperature-oled-mock) on it and produces a
+ * synthetic key:value stream. Reports the sustained consume rate, frame rate, CPU time and peak RSS
+ * of the program, measured after a warm-up period from its exported metrics and /proc.
+ */
+
+#define BENCH_TOPIC "bench"
+#define BENCH_GROUP "bench"
+#define DEFAULT_RATE 1000
+#define DEFAULT_KEYS 4
+#define DEFAULT_PARTITIONS 4
+#define DEFAULT_DURATION_S 10
+#define DEFAULT_WARMUP_S 5
+#define MS_PER_PRODUCE_BATCH 10
+#define MAX_KEY_LEN 32
+
+/* The first keys are the devices known to temperature-oled, so both programs have something to show */
+static const char *device_keys[] = { "leto", "duncan", "chani", "muaddib" };
+
+/**
+ * Figures of the program under test at one point in time.
+ */
+typedef struct BENCH_SAMPLE {
+	long long time_us;
+	long consumed;
+	long frames;
+	long cpu_ticks;  // user + system time in clock ticks
+} BENCH_SAMPLE;
+
+static volatile sig_atomic_t bench_is_running = 1;
+
+static void stop (int sig) {
+	bench_is_running = 0;
+}
+
+/**
+ * @returns the value of a metric in an exported metrics file, or -1 if not found.
+ */
+static long read_metric(const char *path, const char *name) {
+	char line[256];
+	size_t name_len = strlen(name);
+	long value = -1;
+
+	FILE *file = fopen(path, "r");
+	if (!file) return -1;
+	while (fgets(line, sizeof(line), file)) {
+		if (strncmp(line, name, name_len) == 0 && line[name_len] == ' ') {
+			value = atol(line + name_len + 1);
+			break;
+		}
+	}
+	fclose(file);
+	return value;
+}
+
+/**
+ * @returns the user + system CPU time of a process in clock ticks, or -1 on failure.
+ */
+static long read_cpu_ticks(pid_t pid) {
+	char path[64], stat[1024];
+	unsigned long utime, stime;
+
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+	FILE *file = fopen(path, "r");
+	if (!file) return -1;
+	size_t len = fread(stat, 1, sizeof(stat) - 1, file);
+	fclose(file);
+	stat[len] = '\0';
+
+	/* Fields after the command name, which may contain spaces: state is field 3, utime 14, stime 15 */
+	const char *fields = strrchr(stat, ')');
+	if (!fields || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+		return -1;
+	return (long) (utime + stime);
+}
+
+/**
+ * @returns the peak resident set size of a process in kB, or -1 on failure.
+ */
+static long read_peak_rss_kb(pid_t pid) {
+	char path[64], line[256];
+	long value = -1;
+
+	snprintf(path, sizeof(path), "/proc/%d/status", (int) pid);
+	FILE *file = fopen(path, "r");
+	if (!file) return -1;
+	while (fgets(line, sizeof(line), file)) {
+		if (strncmp(line, "VmHWM:", 6) == 0) {
+			value = atol(line + 6);
+			break;
+		}
+	}
+	fclose(file);
+	return value;
+}
+
+static void take_sample(pid_t pid, const char *metrics_path, BENCH_SAMPLE *sample) {
+	sample->time_us = get_monotonic_time_us();
+	sample->consumed = read_metric(metrics_path, "oled_messages_consumed_total");
+	sample->frames = read_metric(metrics_path, "oled_frames_rendered_total");
+	sample->cpu_ticks = read_cpu_ticks(pid);
+}
+
+/**
+ * Run the program under test against the mock cluster: program [options] -m <metrics> <bootstraps> <group> <topic>
+ * Its output is discarded unless verbose.
+ *
+ * @returns the pid of the program, -1 on failure.
+ */
+static pid_t start_program(char **program_argv, int program_argc, const char *metrics_path, const char *bootstraps, int verbose) {
+	char **argv = calloc(program_argc + 6, sizeof(char *));
+	if (!argv) return -1;
+
+	int argc = 0;
+	for (int i = 0; i < program_argc; i++) argv[argc++] = program_argv[i];
+	argv[argc++] = "-m";
+	argv[argc++] = (char *) metrics_path;
+	argv[argc++] = (char *) bootstraps;
+	argv[argc++] = BENCH_GROUP;
+	argv[argc++] = BENCH_TOPIC;
+	argv[argc] = NULL;
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		if (!verbose) {
+			int null_fd = open("/dev/null", O_WRONLY);
+			dup2(null_fd, STDOUT_FILENO);
+			dup2(null_fd, STDERR_FILENO);
+		}
+		execv(argv[0], argv);
+		_exit(127);
+	}
+	free(argv);
+	return pid;
+}
+
+/**
+ * Produce one synthetic message: a key out of key_cnt and a printable temperature value.
+ *
+ * @returns 1 if queued, 0 if the local queue is full.
+ */
+static int produce_message(rd_kafka_t *rk, long sequence, int key_cnt) {
+	char key[MAX_KEY_LEN], value[16];
+	int key_idx = sequence % key_cnt;
+
+	if (key_idx < (int) (sizeof(device_keys) / sizeof(device_keys[0])))
+		snprintf(key, sizeof(key), "%s", device_keys[key_idx]);
+	else
+		snprintf(key, sizeof(key), "key%d", key_idx);
+	snprintf(value, sizeof(value), "%.1f", 45.0f + (sequence * 7 % 130) / 10.0f);
+
+	rd_kafka_resp_err_t err = rd_kafka_producev(rk,
+			RD_KAFKA_V_TOPIC(BENCH_TOPIC),
+			RD_KAFKA_V_KEY(key, strlen(key)),
+			RD_KAFKA_V_VALUE(value, strlen(value)),
+			RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+			RD_KAFKA_V_END);
+	return err == RD_KAFKA_RESP_ERR_NO_ERROR;
+}
+
+int main(int argc, char **argv) {
+	long rate = DEFAULT_RATE;              /* Option: messages produced per second */
+	int key_cnt = DEFAULT_KEYS;            /* Option: distinct message keys */
+	int partition_cnt = DEFAULT_PARTITIONS;/* Option: partitions of the topic */
+	int duration_s = DEFAULT_DURATION_S;   /* Option: measured seconds */
+	int warmup_s = DEFAULT_WARMUP_S;       /* Option: seconds before measuring */
+	int realtime_spi = 0;                  /* Option: mock SPI transfers take as long as on the wire */
+	int verbose = 0;                       /* Option: keep the output of the program under test */
+	char errstr[512];
+	int opt;
+
+	/* Options of the program under test follow its path and are passed on */
+	while ((opt = getopt(argc, argv, "+r:k:p:d:W:sv")) != -1) {
+		switch (opt) {
+		case 'r': rate = atol(optarg); break;
+		case 'k': key_cnt = atoi(optarg); break;
+		case 'p': partition_cnt = atoi(optarg); break;
+		case 'd': duration_s = atoi(optarg); break;
+		case 'W': warmup_s = atoi(optarg); break;
+		case 's': realtime_spi = 1; break;
+		case 'v': verbose = 1; break;
+		default: argc = 0; break;
+		}
+	}
+
+	if (argc - optind < 1 || rate < 1 || key_cnt < 1 || partition_cnt < 1 || duration_s < 1 || warmup_s < 0)
+	{
+		fprintf(stderr,
+				"%% Usage: "
+				"%s [-r rate] [-k keys] [-p partitions] [-d seconds] [-W seconds] [-s] [-v] <program> [program options]\n"
+				"  -r  messages produced per second (default: %d)\n"
+				"  -k  distinct message keys (default: %d)\n"
+				"  -p  partitions of the topic (default: %d)\n"
+				"  -d  measured seconds (default: %d)\n"
+				"  -W  warm-up seconds before measuring (default: %d)\n"
+				"  -s  mock SPI transfers take as long as at the configured clock speed\n"
+				"  -v  show the output of the program\n"
+				"  <program> is a display program linked against the mock display backend, e.g. ./rpi-kafka-oled-mock\n",
+				argv[0], DEFAULT_RATE, DEFAULT_KEYS, DEFAULT_PARTITIONS, DEFAULT_DURATION_S, DEFAULT_WARMUP_S);
+		return 1;
+	}
+
+	/* The producer brings up the mock cluster, which lives in this process */
+	rd_kafka_conf_t *conf = rd_kafka_conf_new();
+	if (rd_kafka_conf_set(conf, "test.mock.num.brokers", "1", errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK ||
+	    rd_kafka_conf_set(conf, "linger.ms", "5", errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+		fprintf(stderr, "%s\n", errstr);
+		rd_kafka_conf_destroy(conf);
+		return 1;
+	}
+	rd_kafka_t *rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+	if (!rk) {
+		fprintf(stderr, "%% Failed to create mock cluster producer: %s\n", errstr);
+		return 1;
+	}
+	rd_kafka_mock_cluster_t *mcluster = rd_kafka_handle_mock_cluster(rk);
+	const char *bootstraps = rd_kafka_mock_cluster_bootstraps(mcluster);
+	rd_kafka_mock_topic_create(mcluster, BENCH_TOPIC, partition_cnt, 1);
+
+	char metrics_path[64];
+	snprintf(metrics_path, sizeof(metrics_path), "/tmp/oled-bench-%d.prom", (int) getpid());
+	if (realtime_spi) setenv("OLED_MOCK_SPI", "realtime", 1);
+
+	pid_t pid = start_program(&argv[optind], argc - optind, metrics_path, bootstraps, verbose);
+	if (pid < 0) {
+		fprintf(stderr, "Failed to start %s.\n", argv[optind]);
+		rd_kafka_destroy(rk);
+		return 1;
+	}
+
+	signal(SIGINT, stop);
+	fprintf(stderr, "%% Producing %ld msg/s with %d keys to %d partitions on %s, warm-up %d s, measuring %d s\n",
+			rate, key_cnt, partition_cnt, bootstraps, warmup_s, duration_s);
+
+	/*
+	 * Produce at the requested rate; the queue is topped up every MS_PER_PRODUCE_BATCH
+	 */
+	BENCH_SAMPLE start = { 0 }, end = { 0 };
+	long long begin_us = get_monotonic_time_us();
+	long long warmup_end_us = begin_us + warmup_s * 1000000LL;
+	long long end_us = warmup_end_us + duration_s * 1000000LL;
+	long produced = 0, produced_at_start = 0, queue_full = 0;
+	int measuring = 0;
+
+	while (bench_is_running) {
+		long long now_us = get_monotonic_time_us();
+		if (now_us >= end_us) break;
+		if (waitpid(pid, NULL, WNOHANG) == pid) {
+			fprintf(stderr, "%s exited early.\n", argv[optind]);
+			pid = -1;
+			break;
+		}
+
+		if (!measuring && now_us >= warmup_end_us) {
+			take_sample(pid, metrics_path, &start);
+			produced_at_start = produced;
+			measuring = 1;
+		}
+
+		long due = (long) ((now_us - begin_us) * rate / 1000000LL);
+		while (produced < due) {
+			if (!produce_message(rk, produced, key_cnt)) {
+				queue_full++;
+				break;
+			}
+			produced++;
+		}
+		rd_kafka_poll(rk, MS_PER_PRODUCE_BATCH);
+	}
+
+	if (pid > 0) {
+		take_sample(pid, metrics_path, &end);
+		long peak_rss_kb = read_peak_rss_kb(pid);
+		kill(pid, SIGINT);
+		waitpid(pid, NULL, 0);
+
+		if (!measuring || start.consumed < 0 || end.consumed < 0) {
+			fprintf(stderr, "No metrics were exported by %s within the warm-up period.\n", argv[optind]);
+		}
+		else {
+			double seconds = (end.time_us - start.time_us) / 1000000.0;
+			double cpu_seconds = (end.cpu_ticks - start.cpu_ticks) / (double) sysconf(_SC_CLK_TCK);
+			printf("produced   %10.0f msg/s\n", (produced - produced_at_start) / seconds);
+			printf("consumed   %10.0f msg/s\n", (end.consumed - start.consumed) / seconds);
+			printf("frames     %10.1f fps\n", (end.frames - start.frames) / seconds);
+			printf("cpu        %10.1f %% of a core (%.2f s)\n", 100.0 * cpu_seconds / seconds, cpu_seconds);
+			printf("peak rss   %10ld kB\n", peak_rss_kb);
+			if (queue_full) printf("producer queue was full %ld time(s), the requested rate was not reached\n", queue_full);
+		}
+	}
+
+	unlink(metrics_path);
+	rd_kafka_destroy(rk);
+	return 0;
+}
@@ -0,0 +1,127 @@
+#include "chart.h"
+
+/**
+ * Position of one series while chart_draw() walks the columns.
+ */
+typedef struct CHART_CURSOR {
+	int point_x;   // last column holding a point, -1 after a gap
+	int next_x;    // next column holding a point or a gap, OLED_WIDTH if none
+	int has_span;  // the previous column was drawn
+	int span_top, span_bottom;
+} CHART_CURSOR;
+
+void chart_init(CHART *chart, CHART_STYLE style, int baseline_y)
+{
+	chart->style = style;
+	chart->baseline_y = baseline_y;
+	chart->series_cnt = 0;
+}
+
+/**
+ * Start a series without points.
+ *
+ * @returns the series, or NULL if the chart already holds CHART_MAX_SERIES.
+ */
+CHART_SERIES *chart_add_series(CHART *chart, unsigned short rgb)
+{
+	if (chart->series_cnt == CHART_MAX_SERIES) return NULL;
+
+	CHART_SERIES *series = &chart->series[chart->series_cnt++];
+	for (int x = 0; x < OLED_WIDTH; x++) {
+		series->top[x] = series->bottom[x] = CHART_NO_POINT;
+	}
+	series->rgb = rgb;
+	return series;
+}
+
+/**
+ * Place a point at column x reaching from row `top` to row `bottom`; for a line or area both are the same row.
+ */
+void chart_point(CHART_SERIES *series, int x, int top, int bottom)
+{
+	if (x < 0 || x >= OLED_WIDTH) return;
+	series->top[x] = top < bottom ? top : bottom;
+	series->bottom[x] = top < bottom ? bottom : top;
+}
+
+/**
+ * Interrupt the series at column x, columns towards the neighbouring points stay empty.
+ */
+void chart_gap(CHART_SERIES *series, int x)
+{
+	if (x < 0 || x >= OLED_WIDTH) return;
+	series->top[x] = series->bottom[x] = CHART_GAP;
+}
+
+/**
+ * Rows covered by the series at column x: the point itself, or interpolated between the points around it.
+ *
+ * @returns 1 if the series is visible in this column, else 0.
+ */
+static int column_rows(const CHART_SERIES *series, CHART_CURSOR *cursor, int x, int *top, int *bottom)
+{
+	int16_t value = series->top[x];
+
+	if (value == CHART_GAP) {
+		cursor->point_x = -1;
+		return 0;
+	}
+	if (value != CHART_NO_POINT) {
+		cursor->point_x = x;
+		*top = value;
+		*bottom = series->bottom[x];
+		return 1;
+	}
+
+	if (cursor->next_x <= x) {
+		for (cursor->next_x = x + 1; cursor->next_x < OLED_WIDTH; cursor->next_x++) {
+			if (series->top[cursor->next_x] != CHART_NO_POINT) break;
+		}
+	}
+	int from = cursor->point_x, to = cursor->next_x;
+	if (from < 0 || to >= OLED_WIDTH || series->top[to] == CHART_GAP) return 0;
+
+	*top = series->top[from] + (series->top[to] - series->top[from]) * (x - from) / (to - from);
+	*bottom = series->bottom[from] + (series->bottom[to] - series->bottom[from]) * (x - from) / (to - from);
+	return 1;
+}
+
+/**
+ * Draw all series from left to right, in the order they were added within each column.
+ * A span reaches over to the span of the previous column, so steep changes stay connected.
+ */
+void chart_draw(const CHART *chart)
+{
+	CHART_CURSOR cursors[CHART_MAX_SERIES];
+
+	for (int i = 0; i < chart->series_cnt; i++) {
+		cursors[i].point_x = -1;
+		cursors[i].next_x = 0;
+		cursors[i].has_span = 0;
+	}
+
+	for (int x = 0; x < OLED_WIDTH; x++) {
+		for (int i = 0; i < chart->series_cnt; i++) {
+			const CHART_SERIES *series = &chart->series[i];
+			CHART_CURSOR *cursor = &cursors[i];
+			int top, bottom;
+
+			if (!column_rows(series, cursor, x, &top, &bottom)) {
+				cursor->has_span = 0;
+				continue;
+			}
+
+			int span_top = top, span_bottom = bottom;
+			if (cursor->has_span) {
+				if (cursor->span_bottom < span_top) span_top = cursor->span_bottom;
+				if (cursor->span_top > span_bottom) span_bottom = cursor->span_top;
+			}
+			cursor->has_span = 1;
+			cursor->span_top = top;
+			cursor->span_bottom = bottom;
+
+			if (chart->style == CHART_AREA) span_bottom = chart->baseline_y;
+			SSD1331_vspan(x, span_top, span_bottom, series->rgb);
+		}
+	}
+}
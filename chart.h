@@ -0,0 +1,41 @@
+#ifndef _CHART_H_
+#define _CHART_H_
+#include <stdint.h>
+#include "ssd1331.h"
+
+#define CHART_MAX_SERIES 8
+#define CHART_NO_POINT INT16_MIN      // column between points, interpolated from its neighbours
+#define CHART_GAP (INT16_MIN + 1)     // no samples at this column, the plot is interrupted
+
+typedef enum CHART_STYLE {
+	CHART_LINE,     // line through the points
+	CHART_AREA,     // filled from the points down to the baseline
+	CHART_ENVELOPE  // band between the lower and upper value of each point
+} CHART_STYLE;
+
+/**
+ * Screen rows of one plotted value stream per pixel column. For a line or area `top` and `bottom` are the same.
+ */
+typedef struct CHART_SERIES {
+	int16_t top[OLED_WIDTH];
+	int16_t bottom[OLED_WIDTH];
+	unsigned short rgb;
+} CHART_SERIES;
+
+/**
+ * Rasterizer drawing every series as one vertical span per column, straight into the framebuffer.
+ * The cost depends on the width and the height of the spans, not on the length of the lines.
+ */
+typedef struct CHART {
+	CHART_STYLE style;
+	int baseline_y;
+	int series_cnt;
+	CHART_SERIES series[CHART_MAX_SERIES];
+} CHART;
+
+void chart_init(CHART *, CHART_STYLE, int);
+CHART_SERIES *chart_add_series(CHART *, unsigned short);
+void chart_point(CHART_SERIES *, int, int, int);
+void chart_gap(CHART_SERIES *, int);
+void chart_draw(const CHART *);
+#endif
@@ -2,5 +2,9 @@
 #define _GUI_H_
 
 #define TOP_DEBUG_STRING_Y     1
-#define BOTTOM_DEBUG_STRING_Y 59
+#define BOTTOM_DEBUG_STRING_Y (OLED_HEIGHT - 5)
+/* Rows of the optional 5x3 readouts below the top line, one each so they can be combined */
+#define STATS_STRING_Y         8
+#define FRESHNESS_STRING_Y    14
+#define ZOOM_STRING_Y         20
 #endif
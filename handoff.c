@@ -0,0 +1,126 @@
+#include "handoff.h"
+#include "kafkautils.h"
+#include "metrics.h"
+
+void handoff_init(HANDOFF *handoff, HANDOFF_POLICY policy, int high_watermark, int low_watermark)
+{
+	pthread_mutex_init(&handoff->lock, NULL);
+	pthread_mutex_init(&handoff->pause_lock, NULL);
+	handoff->head = handoff->depth = handoff->arrivals = 0;
+	handoff->policy = policy;
+	handoff->high_watermark = high_watermark > HANDOFF_CAPACITY ? HANDOFF_CAPACITY : high_watermark;
+	handoff->low_watermark = low_watermark < handoff->high_watermark ? low_watermark : handoff->high_watermark - 1;
+	handoff->paused = 0;
+	handoff->rk = NULL;
+}
+
+static MESSAGE_REF **slot(HANDOFF *handoff, int i)
+{
+	return &handoff->refs[(handoff->head + i) % HANDOFF_CAPACITY];
+}
+
+/**
+ * @returns the waiting message the new one replaces under the handoff policy, or NULL.
+ */
+static MESSAGE_REF **find_coalesced(HANDOFF *handoff, const MESSAGE_REF *ref)
+{
+	if (handoff->policy == HANDOFF_LATEST) {
+		return handoff->depth ? slot(handoff, handoff->depth - 1) : NULL;
+	}
+	if (handoff->policy == HANDOFF_LATEST_PER_KEY) {
+		for (int i = 0; i < handoff->depth; i++) {
+			if (msgref_same_key(*slot(handoff, i), ref)) return slot(handoff, i);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Pause or resume the assigned partitions as the arrivals cross the watermarks.
+ * Runs without holding the queue lock, pausing goes through librdkafka.
+ */
+static void flow_control(HANDOFF *handoff)
+{
+	if (!handoff->rk) return;
+
+	pthread_mutex_lock(&handoff->pause_lock);
+	pthread_mutex_lock(&handoff->lock);
+	int pause = handoff->paused ? handoff->arrivals > handoff->low_watermark
+	                            : handoff->arrivals >= handoff->high_watermark;
+	pthread_mutex_unlock(&handoff->lock);
+
+	if (pause != handoff->paused && kafka_pause(handoff->rk, pause) > 0) handoff->paused = pause;
+	pthread_mutex_unlock(&handoff->pause_lock);
+}
+
+/**
+ * Hand a message over to the renderer, taking over the caller's reference.
+ * Called from the consumer side.
+ */
+void handoff_push(HANDOFF *handoff, MESSAGE_REF *ref)
+{
+	MESSAGE_REF *released = NULL;
+	MESSAGE_REF **coalesced;
+
+	if (!ref) return;
+
+	pthread_mutex_lock(&handoff->lock);
+	coalesced = find_coalesced(handoff, ref);
+	if (coalesced) {
+		released = *coalesced;
+		*coalesced = ref;
+		metrics_add(METRIC_HANDOFF_COALESCED, 1);
+	} else {
+		if (handoff->depth == HANDOFF_CAPACITY) {
+			released = *slot(handoff, 0);
+			handoff->head = (handoff->head + 1) % HANDOFF_CAPACITY;
+			handoff->depth--;
+			metrics_add(METRIC_HANDOFF_DROPPED, 1);
+		}
+		*slot(handoff, handoff->depth) = ref;
+		handoff->depth++;
+	}
+	handoff->arrivals++;
+	metrics_set(METRIC_HANDOFF_DEPTH, handoff->depth);
+	pthread_mutex_unlock(&handoff->lock);
+
+	/* Stop fetching what the renderer could not show anyway */
+	flow_control(handoff);
+	msgref_release(released);
+}
+
+/**
+ * Take the oldest waiting message. Called from the renderer side.
+ *
+ * @returns a reference to be released by the caller, or NULL if nothing is waiting.
+ */
+MESSAGE_REF *handoff_pop(HANDOFF *handoff)
+{
+	MESSAGE_REF *ref = NULL;
+
+	pthread_mutex_lock(&handoff->lock);
+	if (handoff->depth > 0) {
+		ref = *slot(handoff, 0);
+		handoff->head = (handoff->head + 1) % HANDOFF_CAPACITY;
+		handoff->depth--;
+		handoff->arrivals = handoff->depth;
+	}
+	metrics_set(METRIC_HANDOFF_DEPTH, handoff->depth);
+	pthread_mutex_unlock(&handoff->lock);
+
+	flow_control(handoff);
+	return ref;
+}
+
+/**
+ * Release all waiting messages.
+ */
+void handoff_clear(HANDOFF *handoff)
+{
+	pthread_mutex_lock(&handoff->lock);
+	for (int i = 0; i < handoff->depth; i++) {
+		msgref_release(*slot(handoff, i));
+	}
+	handoff->depth = handoff->arrivals = 0;
+	pthread_mutex_unlock(&handoff->lock);
+}
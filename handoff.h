@@ -0,0 +1,43 @@
+#ifndef _HANDOFF_H_
+#define _HANDOFF_H_
+#include <pthread.h>
+#include <librdkafka/rdkafka.h>
+#include "msgref.h"
+
+#define HANDOFF_CAPACITY 64
+
+/**
+ * What happens to a message that is handed over while older ones still wait for the renderer.
+ */
+typedef enum HANDOFF_POLICY {
+	HANDOFF_LATEST,         // only the latest message is kept
+	HANDOFF_LATEST_PER_KEY, // a message replaces a waiting one with the same key
+	HANDOFF_ALL             // every message is queued, the oldest one is dropped when full
+} HANDOFF_POLICY;
+
+/**
+ * Bounded queue of messages between the consumer and the renderer.
+ *
+ * Flow control counts arrivals, not the depth, so it works the same whether messages are
+ * coalesced or queued: when the high watermark of messages was handed over since the renderer
+ * last took one, all assigned partitions are paused. Once the renderer took a message and at most
+ * the low watermark still waits, they are resumed. With the coalescing policies this limits
+ * fetching to about high_watermark messages per render interval.
+ */
+typedef struct HANDOFF {
+	pthread_mutex_t lock;
+	MESSAGE_REF *refs[HANDOFF_CAPACITY];
+	int head, depth;
+	HANDOFF_POLICY policy;
+	int high_watermark, low_watermark;
+	int arrivals;                 // messages handed over and not taken yet, coalesced and dropped ones included
+	pthread_mutex_t pause_lock;   // serializes pausing and resuming, which happens outside of lock
+	int paused;                   // guarded by pause_lock
+	rd_kafka_t *rk;
+} HANDOFF;
+
+void handoff_init(HANDOFF *, HANDOFF_POLICY, int, int);
+void handoff_push(HANDOFF *, MESSAGE_REF *);
+MESSAGE_REF *handoff_pop(HANDOFF *);
+void handoff_clear(HANDOFF *);
+#endif
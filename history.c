@@ -0,0 +1,62 @@
+#include <string.h>
+#include "history.h"
+
+/**
+ * Empty the history and make it keep the latest `capacity` samples, at most HISTORY_CAPACITY.
+ *
+ * @returns 1 on success, -1 if the capacity is out of range.
+ */
+int history_init(HISTORY *history, int capacity)
+{
+	if (capacity < 1 || capacity > HISTORY_CAPACITY) return -1;
+
+	memset(history, 0, sizeof *history);
+	history->capacity = capacity;
+	return 1;
+}
+
+/**
+ * Append a sample shown at screen row `y`. When the history is full the oldest sample is overwritten.
+ */
+void history_push(HISTORY *history, float value, int y)
+{
+	HISTORY_SAMPLE *sample = &history->samples[history->head];
+	float centi = value * 100.0f;
+
+	/* Clamp instead of wrapping around, an out of range value still belongs at the edge of the chart */
+	if (centi > INT16_MAX) centi = INT16_MAX;
+	if (centi < INT16_MIN) centi = INT16_MIN;
+	sample->centi = (int16_t) (centi < 0 ? centi - 0.5f : centi + 0.5f);
+	sample->y = y < 0 ? 0 : y > UINT8_MAX ? UINT8_MAX : y;
+
+	history->head = (history->head + 1) % history->capacity;
+	if (history->count < history->capacity) history->count++;
+}
+
+void history_iter_begin(HISTORY_ITER *iter, const HISTORY *history)
+{
+	iter->history = history;
+	iter->index = 0;
+}
+
+/**
+ * Fetch the next sample, starting with the newest one.
+ *
+ * @returns 1 if a sample was stored in `sample`, 0 after the oldest sample.
+ */
+int history_iter_next(HISTORY_ITER *iter, HISTORY_SAMPLE *sample)
+{
+	const HISTORY *history = iter->history;
+	if (iter->index >= history->count) return 0;
+
+	int slot = history->head - 1 - iter->index;
+	if (slot < 0) slot += history->capacity;
+	*sample = history->samples[slot];
+	iter->index++;
+	return 1;
+}
+
+float history_sample_value(const HISTORY_SAMPLE *sample)
+{
+	return sample->centi / 100.0f;
+}
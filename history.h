@@ -0,0 +1,39 @@
+#ifndef _HISTORY_H_
+#define _HISTORY_H_
+#include <stdint.h>
+
+#define HISTORY_CAPACITY 96 // one sample per pixel column of the SSD1331, stretched across wider panels
+
+/**
+ * One chart sample: the value in hundredths, so it survives rescaling the chart,
+ * and the screen y it was quantized to when it was taken.
+ */
+typedef struct HISTORY_SAMPLE {
+	int16_t centi;
+	uint8_t y;
+} HISTORY_SAMPLE;
+
+/**
+ * Ring buffer of the latest samples of one value stream. Appending overwrites the oldest sample.
+ */
+typedef struct HISTORY {
+	HISTORY_SAMPLE samples[HISTORY_CAPACITY];
+	int capacity;
+	int head;  // index the next sample is written to
+	int count;
+} HISTORY;
+
+/**
+ * Walks the samples of a HISTORY from the newest to the oldest one.
+ */
+typedef struct HISTORY_ITER {
+	const HISTORY *history;
+	int index;
+} HISTORY_ITER;
+
+int history_init(HISTORY *, int);
+void history_push(HISTORY *, float, int);
+void history_iter_begin(HISTORY_ITER *, const HISTORY *);
+int history_iter_next(HISTORY_ITER *, HISTORY_SAMPLE *);
+float history_sample_value(const HISTORY_SAMPLE *);
+#endif
@@ -0,0 +1,70 @@
+#include "ssd1331.h"
+#include "metrics.h"
+#include "idle.h"
+
+void idle_init(IDLE *idle, long after_ms, long frame_ms, int freeze_background, long now_ms)
+{
+	idle->after_ms = after_ms;
+	idle->frame_ms = frame_ms;
+	idle->freeze_background = freeze_background;
+	idle->state = IDLE_ACTIVE;
+	idle->consumed = metrics_get(METRIC_MESSAGES_CONSUMED);
+	idle->data_ms = now_ms;
+	idle->since_ms = now_ms;
+	idle->frame_due_ms = now_ms;
+	metrics_set(METRIC_IDLE, 0);
+}
+
+/**
+ * Dim the panel once no message arrived for `after_ms`, and bring it back to full brightness
+ * as soon as one does. Time spent idle is accounted in the metrics on every call.
+ *
+ * @returns IDLE_ENTERED or IDLE_LEFT on a transition, 0 otherwise.
+ */
+int idle_update(IDLE *idle, long now_ms)
+{
+	long consumed = metrics_get(METRIC_MESSAGES_CONSUMED);
+	int data = consumed != idle->consumed;
+	idle->consumed = consumed;
+	if (data) idle->data_ms = now_ms;
+
+	if (idle->state == IDLE_DIMMED) {
+		metrics_add(METRIC_IDLE_MS, now_ms - idle->since_ms);
+		idle->since_ms = now_ms;
+		if (!data) return 0;
+
+		SSD1331_dim(0);
+		idle->state = IDLE_ACTIVE;
+		metrics_set(METRIC_IDLE, 0);
+		return IDLE_LEFT;
+	}
+
+	if (!idle->after_ms || now_ms - idle->data_ms < idle->after_ms) return 0;
+
+	SSD1331_dim(1);
+	idle->state = IDLE_DIMMED;
+	idle->since_ms = now_ms;
+	idle->frame_due_ms = now_ms;
+	metrics_set(METRIC_IDLE, 1);
+	metrics_add(METRIC_IDLE_ENTERED, 1);
+	return IDLE_ENTERED;
+}
+
+/**
+ * @returns 1 if a frame should be rendered now: always while active, every `frame_ms` while idle.
+ */
+int idle_frame_due(IDLE *idle, long now_ms)
+{
+	if (idle->state == IDLE_ACTIVE) return 1;
+	if (now_ms < idle->frame_due_ms) return 0;
+	idle->frame_due_ms = now_ms + idle->frame_ms;
+	return 1;
+}
+
+/**
+ * @returns frame interval of the current state, `active_ms` while active.
+ */
+long idle_tick_ms(const IDLE *idle, long active_ms)
+{
+	return idle->state == IDLE_DIMMED ? idle->frame_ms : active_ms;
+}
@@ -0,0 +1,35 @@
+#ifndef _IDLE_H_
+#define _IDLE_H_
+
+#define IDLE_AFTER_MS 300000      // time without messages until the display goes idle
+#define IDLE_FRAME_MS 1000        // frame interval while idle
+
+typedef enum IDLE_STATE {
+	IDLE_ACTIVE,
+	IDLE_DIMMED
+} IDLE_STATE;
+
+/* Returned by idle_update() */
+#define IDLE_ENTERED 1
+#define IDLE_LEFT    2
+
+/**
+ * Idle state of a display program. Data arriving is noticed through the consumed message counter,
+ * so the consumer does not have to report to it, whichever thread it runs on.
+ */
+typedef struct IDLE {
+	long after_ms;          // 0 never goes idle
+	long frame_ms;
+	int freeze_background;  // stop animating the background while idle
+	IDLE_STATE state;
+	long consumed;          // consumed message count at the last update
+	long data_ms;           // time the last message was noticed
+	long since_ms;          // time the current state was entered, or idle time was last accounted
+	long frame_due_ms;
+} IDLE;
+
+void idle_init(IDLE *, long, long, int, long);
+int idle_update(IDLE *, long);
+int idle_frame_due(IDLE *, long);
+long idle_tick_ms(const IDLE *, long);
+#endif
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+#include <librdkafka/rdkafka.h>
+#include "kafkastats.h"
+#include "metrics.h"
+
+#define STATS_MAX_DEPTH 8
+#define STATS_MAX_KEY 64
+
+/**
+ * State of the streaming parser: the key of every enclosing object member, nothing else is kept.
+ * The document is scanned once without building a tree, values are handed to extract_value().
+ */
+typedef struct STATS_PARSER {
+	int depth;                               // 0 outside the document, 1 inside the top level object
+	int is_object[STATS_MAX_DEPTH + 1];
+	char keys[STATS_MAX_DEPTH + 1][STATS_MAX_KEY];
+	int expect_key;
+} STATS_PARSER;
+
+/**
+ * @returns 1 if the key at the given depth equals name, else 0.
+ */
+static int key_is(const STATS_PARSER *parser, int depth, const char *name) {
+	return depth <= parser->depth && depth <= STATS_MAX_DEPTH && strcmp(parser->keys[depth], name) == 0;
+}
+
+/**
+ * Pick the figures we are interested in by their path:
+ *   brokers.<name>.rtt.avg
+ *   topics.<topic>.partitions.<partition>.consumer_lag / fetchq_cnt
+ *   cgrp.rebalance_cnt
+ */
+static void extract_value(const STATS_PARSER *parser, long value, KAFKA_STATS *stats) {
+	if (parser->depth == 4 && key_is(parser, 1, "brokers") && key_is(parser, 3, "rtt") && key_is(parser, 4, "avg")) {
+		if (value > stats->rtt_avg_us) stats->rtt_avg_us = value;
+	}
+	else if (parser->depth == 5 && key_is(parser, 1, "topics") && key_is(parser, 3, "partitions")) {
+		/* Partition -1 holds messages not assigned to a partition yet */
+		if (key_is(parser, 4, "-1")) return;
+		if (key_is(parser, 5, "consumer_lag") && value >= 0) {
+			stats->consumer_lag += value;
+			if (value > stats->consumer_lag_max) stats->consumer_lag_max = value;
+		}
+		else if (key_is(parser, 5, "fetchq_cnt")) {
+			stats->fetchq_cnt += value;
+		}
+	}
+	else if (parser->depth == 2 && key_is(parser, 1, "cgrp") && key_is(parser, 2, "rebalance_cnt")) {
+		stats->rebalance_cnt = value;
+	}
+}
+
+/**
+ * Extract the key figures from a statistics document.
+ * Integer parts of numbers are used, strings other than keys are skipped.
+ *
+ * @returns 1 on success, -1 if the document is malformed.
+ */
+int kafka_stats_parse(const char *json, size_t len, KAFKA_STATS *stats) {
+	STATS_PARSER parser = { 0 };
+	size_t i = 0;
+
+	memset(stats, 0, sizeof(*stats));
+
+	while (i < len && json[i]) {
+		char c = json[i];
+
+		if (c == '{' || c == '[') {
+			parser.depth++;
+			if (parser.depth <= STATS_MAX_DEPTH) {
+				parser.is_object[parser.depth] = c == '{';
+				parser.keys[parser.depth][0] = '\0';
+			}
+			parser.expect_key = c == '{';
+			i++;
+		}
+		else if (c == '}' || c == ']') {
+			if (--parser.depth < 0) return -1;
+			parser.expect_key = 0;
+			i++;
+		}
+		else if (c == ',') {
+			parser.expect_key = parser.depth <= STATS_MAX_DEPTH && parser.is_object[parser.depth];
+			i++;
+		}
+		else if (c == ':') {
+			parser.expect_key = 0;
+			i++;
+		}
+		else if (c == '"') {
+			/* Copy keys (truncated), skip over string values */
+			size_t start = ++i;
+			while (i < len && json[i] != '"') i += json[i] == '\\' ? 2 : 1;
+			if (i >= len) return -1;
+			if (parser.expect_key && parser.depth <= STATS_MAX_DEPTH) {
+				size_t key_len = i - start < STATS_MAX_KEY - 1 ? i - start : STATS_MAX_KEY - 1;
+				memcpy(parser.keys[parser.depth], json + start, key_len);
+				parser.keys[parser.depth][key_len] = '\0';
+			}
+			i++;
+		}
+		else if (c == '-' || (c >= '0' && c <= '9')) {
+			long value = 0;
+			int negative = c == '-';
+			if (negative) i++;
+			while (i < len && json[i] >= '0' && json[i] <= '9') value = value * 10 + (json[i++] - '0');
+			/* Skip fraction and exponent */
+			while (i < len && (json[i] == '.' || json[i] == 'e' || json[i] == 'E' || json[i] == '+' || json[i] == '-' || (json[i] >= '0' && json[i] <= '9'))) i++;
+			if (parser.depth <= STATS_MAX_DEPTH && parser.is_object[parser.depth])
+				extract_value(&parser, negative ? -value : value, stats);
+		}
+		else {
+			/* Whitespace and the literals true, false and null */
+			i++;
+		}
+	}
+
+	return parser.depth == 0 ? 1 : -1;
+}
+
+/**
+ * Statistics callback, called every statistics.interval.ms from the thread polling the consumer.
+ * Publishes the key figures as metrics.
+ *
+ * @returns 0 so librdkafka frees the document.
+ */
+int kafka_stats_cb(rd_kafka_t *rk, char *json, size_t json_len, void *opaque) {
+	KAFKA_STATS stats;
+
+	if (kafka_stats_parse(json, json_len, &stats) < 0) {
+		fprintf(stderr, "%% Failed to parse statistics\n");
+		return 0;
+	}
+
+	metrics_set(METRIC_BROKER_RTT_US, stats.rtt_avg_us);
+	metrics_set(METRIC_CONSUMER_LAG, stats.consumer_lag);
+	metrics_set(METRIC_CONSUMER_LAG_MAX, stats.consumer_lag_max);
+	metrics_set(METRIC_FETCH_QUEUE_MESSAGES, stats.fetchq_cnt);
+	metrics_set(METRIC_REBALANCES, stats.rebalance_cnt);
+	metrics_add(METRIC_STATISTICS_RECEIVED, 1);
+	return 0;
+}
+
+/**
+ * Format a compact lag and round trip time readout, e.g. "lag 12 rtt 3ms".
+ *
+ * @returns 1 if text was written, 0 if no statistics were received yet.
+ */
+int kafka_stats_describe(char *text, size_t size) {
+	if (!metrics_get(METRIC_STATISTICS_RECEIVED)) return 0;
+
+	snprintf(text, size, "lag %ld rtt %ldms",
+		 metrics_get(METRIC_CONSUMER_LAG), (metrics_get(METRIC_BROKER_RTT_US) + 500) / 1000);
+	return 1;
+}
@@ -0,0 +1,20 @@
+#ifndef _KAFKASTATS_H_
+#define _KAFKASTATS_H_
+#include <stddef.h>
+#include <librdkafka/rdkafka.h>
+
+/**
+ * Key figures extracted from a librdkafka statistics JSON document.
+ */
+typedef struct KAFKA_STATS {
+	long rtt_avg_us;        // highest average round trip time of all brokers
+	long consumer_lag;      // messages behind the high watermark, summed over the assigned partitions
+	long consumer_lag_max;  // messages behind the high watermark of the partition furthest behind
+	long fetchq_cnt;        // messages fetched but not yet consumed
+	long rebalance_cnt;     // consumer group rebalances since start-up
+} KAFKA_STATS;
+
+int kafka_stats_parse(const char *, size_t, KAFKA_STATS *);
+int kafka_stats_cb(rd_kafka_t *, char *, size_t, void *);
+int kafka_stats_describe(char *, size_t);
+#endif
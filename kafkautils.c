@@ -2,16 +2,473 @@
 #include <signal.h>
 #include <librdkafka/rdkafka.h>
 #include <pthread.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "metrics.h"
+#include "kafkastats.h"
+#include "msglog.h"
+#include "timeops.h"
 
 typedef struct KAFKA_CONSUMER_ARGS {
 	rd_kafka_t *rk; // pointer to kafka consumer instance
 	char *payload; // the latest message text from the topic will be stored in this pointer
 } KAFKA_CONSUMER_ARGS;
 
+/**
+ * Progress of an assigned partition.
+ */
+typedef struct KAFKA_PARTITION_STATE {
+	char topic[KAFKA_MAX_TOPIC_LEN];
+	int32_t partition;
+	int64_t applied;       // offset following the last message handed to the application (-1 = unknown)
+	int64_t startup_high;  // high watermark when the partition was assigned (fast start only)
+	int64_t skip_floor;    // messages below this offset were already skipped over
+	int caught_up;
+	rd_kafka_queue_t *queue;  // partition queue forwarded to a worker, NULL without workers
+} KAFKA_PARTITION_STATE;
+
+/**
+ * Decode worker: a thread consuming a queue that the queues of its partitions are forwarded to.
+ */
+typedef struct KAFKA_WORKER {
+	pthread_t thread;
+	rd_kafka_t *rk;
+	rd_kafka_queue_t *queue;
+} KAFKA_WORKER;
+
+/**
+ * Message read back from a message log. Key and payload point into the mapped log.
+ */
+typedef struct KAFKA_REPLAYED_MESSAGE {
+	rd_kafka_message_t rkm;  // has to be the first member
+	const char *topic;
+	int64_t timestamp;
+} KAFKA_REPLAYED_MESSAGE;
+
+/* Marks messages created by kafka_consumer_poll() from a message log */
+static const char replayed_marker = 0;
+
+static KAFKA_OPTIONS kafka_options;
+static KAFKA_PARTITION_STATE partition_states[KAFKA_MAX_PARTITIONS];
+static int partition_state_cnt = 0;
+static pthread_mutex_t partition_lock = PTHREAD_MUTEX_INITIALIZER;
+static KAFKA_OFFSET resume_offsets[KAFKA_MAX_PARTITIONS];
+static int resume_offset_cnt = 0;
+static volatile int all_caught_up = 0;
+static volatile int partitions_paused = 0;
+static KAFKA_WORKER workers[KAFKA_MAX_WORKERS];
+static int worker_cnt = 0;
+static volatile int workers_running = 0;
+static MSGLOG *record_log = NULL;
+static pthread_mutex_t record_lock = PTHREAD_MUTEX_INITIALIZER; /* guards record_log, several workers record */
+static MSGLOG *replay_log = NULL;
+static uint64_t replay_pos = 0;
+static int replay_realtime = 0;
+static int64_t replay_first_timestamp = -1;
+static long long replay_start_us = 0;
+static long replay_cnt = 0;
+
+static KAFKA_PARTITION_STATE *find_partition_state(const char *topic, int32_t partition) {
+        for (int i = 0 ; i < partition_state_cnt ; i++) {
+                KAFKA_PARTITION_STATE *state = &partition_states[i];
+                if (state->partition == partition && strcmp(state->topic, topic) == 0)
+                        return state;
+        }
+        return NULL;
+}
+
+static KAFKA_OFFSET *find_resume_offset(const char *topic, int32_t partition) {
+        for (int i = 0 ; i < resume_offset_cnt ; i++) {
+                KAFKA_OFFSET *offset = &resume_offsets[i];
+                if (offset->partition == partition && strcmp(offset->topic, topic) == 0)
+                        return offset;
+        }
+        return NULL;
+}
+
+/**
+ * Remember where to resume a partition should it be assigned to us again.
+ */
+static void set_resume_offset(const char *topic, int32_t partition, int64_t value) {
+        KAFKA_OFFSET *offset = find_resume_offset(topic, partition);
+        if (!offset) {
+                if (resume_offset_cnt >= KAFKA_MAX_PARTITIONS)
+                        return;
+                offset = &resume_offsets[resume_offset_cnt++];
+                snprintf(offset->topic, sizeof(offset->topic), "%s", topic);
+                offset->partition = partition;
+        }
+        offset->offset = value;
+}
+
+static void update_caught_up(void) {
+        for (int i = 0 ; i < partition_state_cnt ; i++)
+                if (!partition_states[i].caught_up) {
+                        all_caught_up = 0;
+                        return;
+                }
+        all_caught_up = partition_state_cnt > 0;
+}
+
+/**
+ * Rewinds a newly assigned partition so that only the last `history` messages are replayed.
+ *
+ * A committed (or initial) offset is kept when it already lies within that window, so a
+ * restarting consumer does not re-read messages it has already seen.
+ */
+static void fast_start_partition(rd_kafka_t *rk, rd_kafka_topic_partition_t *p, KAFKA_PARTITION_STATE *state) {
+        rd_kafka_resp_err_t err;
+        int64_t low, high, target;
+
+        err = rd_kafka_query_watermark_offsets(rk, p->topic, p->partition,
+                                               &low, &high, 5000);
+        if (err) {
+                fprintf(stderr,
+                        "%% Failed to query watermarks of %s [%"PRId32"]: %s\n",
+                        p->topic, p->partition, rd_kafka_err2str(err));
+                return;
+        }
+
+        target = high - kafka_options.history;
+        if (target < low)
+                target = low;
+        if (p->offset < target)
+                p->offset = target;
+
+        fprintf(stderr, "%% Fast start: %s [%"PRId32"] from offset %"PRId64
+                " (high watermark %"PRId64")\n",
+                p->topic, p->partition, p->offset, high);
+
+        if (state) {
+                state->startup_high = high;
+                state->caught_up = p->offset >= high;
+        }
+}
+
+/**
+ * Redirect the messages of a partition to one of the workers.
+ * A partition is always handled by the same worker, which preserves the order within the partition.
+ */
+static void forward_to_worker(rd_kafka_t *rk, const rd_kafka_topic_partition_t *p, KAFKA_PARTITION_STATE *state, int idx) {
+        rd_kafka_queue_t *queue = rd_kafka_queue_get_partition(rk, p->topic, p->partition);
+        if (!queue)
+                return;
+
+        rd_kafka_queue_forward(queue, workers[idx % worker_cnt].queue);
+        if (state)
+                state->queue = queue;
+        else
+                rd_kafka_queue_destroy(queue);
+}
+
+/**
+ * Stop forwarding the partition queues of the current assignment and release them.
+ */
+static void release_partition_queues(void) {
+        for (int i = 0 ; i < partition_state_cnt ; i++) {
+                KAFKA_PARTITION_STATE *state = &partition_states[i];
+                if (!state->queue)
+                        continue;
+                rd_kafka_queue_forward(state->queue, NULL);
+                rd_kafka_queue_destroy(state->queue);
+                state->queue = NULL;
+        }
+}
+
+/**
+ * Decides the starting offset of each newly assigned partition and assigns them.
+ *
+ * A partition resumes where the application state left it: at the initial offset passed in
+ * KAFKA_OPTIONS or, if it was assigned to us before, after the last applied message.
+ * Those take precedence over committed offsets, fast start mode may move either of them forward.
+ */
+static void assign_partitions(rd_kafka_t *rk, rd_kafka_topic_partition_list_t *partitions) {
+        rd_kafka_resp_err_t err;
+        int i;
+
+        if (kafka_options.fast_start) {
+                err = rd_kafka_committed(rk, partitions, 5000);
+                if (err)
+                        fprintf(stderr, "%% Failed to fetch committed offsets: %s\n",
+                                rd_kafka_err2str(err));
+        }
+
+        pthread_mutex_lock(&partition_lock);
+        partition_state_cnt = 0;
+        for (i = 0 ; i < partitions->cnt ; i++) {
+                rd_kafka_topic_partition_t *p = &partitions->elems[i];
+                const KAFKA_OFFSET *resume = find_resume_offset(p->topic, p->partition);
+                KAFKA_PARTITION_STATE *state = NULL;
+
+                if (partition_state_cnt < KAFKA_MAX_PARTITIONS) {
+                        state = &partition_states[partition_state_cnt++];
+                        snprintf(state->topic, sizeof(state->topic), "%s", p->topic);
+                        state->partition = p->partition;
+                        state->startup_high = -1;
+                        state->skip_floor = 0;
+                        state->caught_up = 0;
+                        state->queue = NULL;
+                }
+
+                if (worker_cnt > 0)
+                        forward_to_worker(rk, p, state, i);
+
+                if (resume)
+                        p->offset = resume->offset;
+
+                if (kafka_options.fast_start)
+                        fast_start_partition(rk, p, state);
+
+                if (state)
+                        state->applied = p->offset >= 0 ? p->offset : -1;
+        }
+        if (kafka_options.fast_start)
+                update_caught_up();
+        pthread_mutex_unlock(&partition_lock);
+
+        rd_kafka_assign(rk, partitions);
+
+        /* Partitions assigned while the application is applying backpressure start out paused */
+        if (partitions_paused)
+                rd_kafka_pause_partitions(rk, partitions);
+}
+
+/**
+ * Rebalance callback keeping track of the assigned partitions.
+ */
+static void rebalance_cb(rd_kafka_t *rk, rd_kafka_resp_err_t err,
+                         rd_kafka_topic_partition_list_t *partitions, void *opaque) {
+        switch (err) {
+        case RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS:
+                assign_partitions(rk, partitions);
+                break;
+        case RD_KAFKA_RESP_ERR__REVOKE_PARTITIONS:
+                pthread_mutex_lock(&partition_lock);
+                for (int i = 0 ; i < partition_state_cnt ; i++)
+                        if (partition_states[i].applied >= 0)
+                                set_resume_offset(partition_states[i].topic,
+                                                  partition_states[i].partition,
+                                                  partition_states[i].applied);
+                release_partition_queues();
+                partition_state_cnt = 0;
+                all_caught_up = 0;
+                pthread_mutex_unlock(&partition_lock);
+                rd_kafka_assign(rk, NULL);
+                break;
+        default:
+                fprintf(stderr, "%% Rebalance failed: %s\n", rd_kafka_err2str(err));
+                rd_kafka_assign(rk, NULL);
+                break;
+        }
+}
+
+/**
+ * Bookkeeping for every consumed message. Has to be called from the consumer thread
+ * once the message has been applied to the application state.
+ *
+ * Remembers the offset of the message, marks partitions that reached their startup high watermark
+ * and, when max_lag is set, seeks a partition that fell too far behind to the last `history` messages.
+ */
+void kafka_track_message(rd_kafka_t *rk, const rd_kafka_message_t *rkm) {
+        const char *topic = kafka_message_topic(rkm);
+        KAFKA_PARTITION_STATE *state;
+        int64_t low, high;
+
+        metrics_add(METRIC_MESSAGES_CONSUMED, 1);
+
+        pthread_mutex_lock(&record_lock);
+        if (record_log && msglog_append(record_log, topic, rkm->partition, rkm->offset,
+                                        kafka_message_timestamp(rkm), rkm->key, rkm->key_len,
+                                        rkm->payload, rkm->len) < 0) {
+                fprintf(stderr, "%% Failed to record message, recording stopped\n");
+                msglog_close(record_log);
+                record_log = NULL;
+        }
+        pthread_mutex_unlock(&record_lock);
+
+        /* Replayed messages have no consumer behind them */
+        if (!rk)
+                return;
+
+        pthread_mutex_lock(&partition_lock);
+        state = find_partition_state(topic, rkm->partition);
+        if (state) {
+                state->applied = rkm->offset + 1;
+                if (!state->caught_up && state->startup_high >= 0 && rkm->offset + 1 >= state->startup_high) {
+                        state->caught_up = 1;
+                        update_caught_up();
+                }
+        }
+
+        if (kafka_options.max_lag <= 0 || (state && rkm->offset < state->skip_floor)) {
+                pthread_mutex_unlock(&partition_lock);
+                return;
+        }
+
+        /* Cached watermarks are refreshed by every fetch response, so this does not block */
+        if (rd_kafka_get_watermark_offsets(rk, topic, rkm->partition, &low, &high) == RD_KAFKA_RESP_ERR_NO_ERROR
+            && high - (rkm->offset + 1) > kafka_options.max_lag
+            && high - kafka_options.history > rkm->offset) {
+                int64_t target = high - kafka_options.history;
+                fprintf(stderr, "%% %s [%"PRId32"] is %"PRId64" messages behind, skipping to offset %"PRId64"\n",
+                        topic, rkm->partition, high - (rkm->offset + 1), target);
+                if (rd_kafka_seek(rkm->rkt, rkm->partition, target, 0) == RD_KAFKA_RESP_ERR_NO_ERROR) {
+                        if (state)
+                                state->skip_floor = target;
+                        metrics_add(METRIC_LAG_SKIPS, 1);
+                }
+        }
+        pthread_mutex_unlock(&partition_lock);
+}
+
+/**
+ * @returns 1 once every assigned partition has been consumed up to its startup high watermark.
+ * Always 0 unless fast start is enabled.
+ */
+int kafka_caught_up(void) {
+        return all_caught_up;
+}
+
+/**
+ * Copy the offsets following the last applied message of each assigned partition into `offsets`.
+ * Partitions without a known position are left out.
+ *
+ * @returns the amount of offsets written.
+ */
+int kafka_applied_offsets(KAFKA_OFFSET *offsets, int max_cnt) {
+        int cnt = 0;
+
+        pthread_mutex_lock(&partition_lock);
+        for (int i = 0 ; i < partition_state_cnt && cnt < max_cnt ; i++) {
+                const KAFKA_PARTITION_STATE *state = &partition_states[i];
+                if (state->applied < 0)
+                        continue;
+                snprintf(offsets[cnt].topic, sizeof(offsets[cnt].topic), "%s", state->topic);
+                offsets[cnt].partition = state->partition;
+                offsets[cnt].offset = state->applied;
+                cnt++;
+        }
+        pthread_mutex_unlock(&partition_lock);
+
+        return cnt;
+}
+
+/**
+ * Store the given offsets, to be committed by the next (auto) commit.
+ * Only meaningful when the handler was created with manual_offset_store.
+ */
+void kafka_store_offsets(rd_kafka_t *rk, const KAFKA_OFFSET *offsets, int cnt) {
+        rd_kafka_topic_partition_list_t *list;
+        rd_kafka_resp_err_t err;
+
+        if (!rk || cnt <= 0)
+                return;
+
+        list = rd_kafka_topic_partition_list_new(cnt);
+        for (int i = 0 ; i < cnt ; i++)
+                rd_kafka_topic_partition_list_add(list, offsets[i].topic,
+                                                  offsets[i].partition)->offset = offsets[i].offset;
+
+        err = rd_kafka_offsets_store(rk, list);
+        if (err)
+                fprintf(stderr, "%% Failed to store offsets: %s\n", rd_kafka_err2str(err));
+
+        rd_kafka_topic_partition_list_destroy(list);
+}
+
+/**
+ * Pause (pause = 1) or resume (pause = 0) fetching of all assigned partitions.
+ * Partitions assigned later inherit the paused state.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int kafka_pause(rd_kafka_t *rk, int pause) {
+        rd_kafka_topic_partition_list_t *partitions;
+        rd_kafka_resp_err_t err;
+
+        if (!rk)
+                return -1;
+
+        err = rd_kafka_assignment(rk, &partitions);
+        if (err) {
+                fprintf(stderr, "%% Failed to get assignment: %s\n", rd_kafka_err2str(err));
+                return -1;
+        }
+
+        if (pause)
+                err = rd_kafka_pause_partitions(rk, partitions);
+        else
+                err = rd_kafka_resume_partitions(rk, partitions);
+        rd_kafka_topic_partition_list_destroy(partitions);
+
+        if (err) {
+                fprintf(stderr, "%% Failed to %s partitions: %s\n",
+                        pause ? "pause" : "resume", rd_kafka_err2str(err));
+                return -1;
+        }
+
+        partitions_paused = pause;
+        metrics_add(pause ? METRIC_PAUSES : METRIC_RESUMES, 1);
+        return 1;
+}
+
+/**
+ * Decode worker thread: handles the messages of the partitions forwarded to its queue, in order.
+ */
+static void *run_worker(void *arg) {
+        KAFKA_WORKER *worker = (KAFKA_WORKER *) arg;
+
+        while (workers_running) {
+                rd_kafka_message_t *rkm = rd_kafka_consume_queue(worker->queue, 100);
+                if (!rkm)
+                        continue;
+
+                if (rkm->err) {
+                        fprintf(stderr, "%% Consumer error: %s\n",
+                                rd_kafka_message_errstr(rkm));
+                        rd_kafka_message_destroy(rkm);
+                        continue;
+                }
+
+                kafka_options.handler(worker->rk, rkm, kafka_options.handler_opaque);
+        }
+        return NULL;
+}
+
+static int start_workers(rd_kafka_t *rk) {
+        worker_cnt = kafka_options.workers < KAFKA_MAX_WORKERS ? kafka_options.workers : KAFKA_MAX_WORKERS;
+        workers_running = 1;
+        for (int i = 0 ; i < worker_cnt ; i++) {
+                workers[i].rk = rk;
+                workers[i].queue = rd_kafka_queue_new(rk);
+                if (pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) != 0) {
+                        rd_kafka_queue_destroy(workers[i].queue);
+                        worker_cnt = i;
+                        return -1;
+                }
+        }
+        fprintf(stderr, "%% Started %d decode worker(s)\n", worker_cnt);
+        return 1;
+}
+
+/**
+ * Stop and join the decode workers. Has to be called before the consumer is closed.
+ */
+void kafka_stop_workers(void) {
+        workers_running = 0;
+        for (int i = 0 ; i < worker_cnt ; i++) {
+                pthread_join(workers[i].thread, NULL);
+                rd_kafka_queue_destroy(workers[i].queue);
+        }
+        worker_cnt = 0;
+}
+
 /**
  * Initialize a kafka subscription handler and return the pointer to it.
  */
-rd_kafka_t *init_kafka_handler(const char *brokers, const char *groupid, int topic_cnt, char **topics) {
+rd_kafka_t *init_kafka_handler(const char *brokers, const char *groupid, int topic_cnt, char **topics, const KAFKA_OPTIONS *options) {
 
 		rd_kafka_t *rk;          /* Consumer instance handle */
         rd_kafka_conf_t *conf;   /* Temporary configuration object */
@@ -60,6 +517,55 @@ rd_kafka_t *init_kafka_handler(const char *brokers, const char *groupid, int top
                 return NULL;
         }
 
+        if (options) {
+                kafka_options = *options;
+                if (kafka_options.history < 1)
+                        kafka_options.history = 1;
+                for (i = 0 ; i < options->initial_offset_cnt ; i++)
+                        set_resume_offset(options->initial_offsets[i].topic,
+                                          options->initial_offsets[i].partition,
+                                          options->initial_offsets[i].offset);
+        }
+
+        /* Offsets are only stored (and thereby committed) when the application
+         * says so, e.g. after the state built from them has been persisted. */
+        if (kafka_options.manual_offset_store &&
+            rd_kafka_conf_set(conf, "enable.auto.offset.store", "false",
+                              errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+                fprintf(stderr, "%s\n", errstr);
+                rd_kafka_conf_destroy(conf);
+                return NULL;
+        }
+
+        /* Every consumed message is appended to a message log for replay */
+        if (kafka_options.record_path) {
+                record_log = msglog_create(kafka_options.record_path);
+                if (!record_log) {
+                        fprintf(stderr, "%% Failed to create message log %s\n", kafka_options.record_path);
+                        rd_kafka_conf_destroy(conf);
+                        return NULL;
+                }
+        }
+
+        /* Broker round trip times, consumer lag and rebalances are
+         * taken from the statistics librdkafka emits periodically. */
+        if (kafka_options.statistics_interval_ms > 0) {
+                char interval[16];
+                snprintf(interval, sizeof(interval), "%d", kafka_options.statistics_interval_ms);
+                if (rd_kafka_conf_set(conf, "statistics.interval.ms", interval,
+                                      errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+                        fprintf(stderr, "%s\n", errstr);
+                        rd_kafka_conf_destroy(conf);
+                        return NULL;
+                }
+                rd_kafka_conf_set_stats_cb(conf, kafka_stats_cb);
+        }
+
+        /* Partitions are assigned by our own rebalance callback, which
+         * decides the starting offset of each partition and keeps track
+         * of the consumer position. */
+        rd_kafka_conf_set_rebalance_cb(conf, rebalance_cb);
+
         /*
          * Create consumer instance.
          *
@@ -88,6 +594,17 @@ rd_kafka_t *init_kafka_handler(const char *brokers, const char *groupid, int top
          * but that is more complex and typically not recommended. */
         rd_kafka_poll_set_consumer(rk);
 
+        /* With decode workers the rebalance callback takes the queue of each
+         * assigned partition out of the main queue and forwards it to a worker.
+         * The main queue then only carries events and consumer errors. */
+        if (kafka_options.workers > 0 && kafka_options.handler &&
+            start_workers(rk) < 0) {
+                fprintf(stderr, "%% Failed to start decode workers\n");
+                kafka_stop_workers();
+                rd_kafka_destroy(rk);
+                return NULL;
+        }
+
 
         /* Convert the list of topics to a format suitable for librdkafka */
         subscription = rd_kafka_topic_partition_list_new(topic_cnt);
@@ -119,3 +636,145 @@ rd_kafka_t *init_kafka_handler(const char *brokers, const char *groupid, int top
 		return rk;
 }
 
+
+/**
+ * Feed the messages of a log written with KAFKA_OPTIONS.record_path to kafka_consumer_poll()
+ * instead of consuming from Kafka; no consumer is created then and NULL is used as handle.
+ *
+ * With realtime the messages are returned at the pace they were recorded at and get_current_time()
+ * runs from the timestamp of the first message on. Otherwise they are returned as fast as possible
+ * and get_current_time() stands at the timestamp of the latest message.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int kafka_start_replay(const char *path, int realtime) {
+        replay_log = msglog_open(path);
+        if (!replay_log)
+                return -1;
+
+        replay_pos = 0;
+        replay_realtime = realtime;
+        replay_cnt = 0;
+
+        /* Anchor the virtual clock at the first message */
+        uint64_t pos = 0;
+        const MSGLOG_ENTRY *first = msglog_entry(replay_log, &pos);
+        replay_first_timestamp = first ? first->timestamp : -1;
+        replay_start_us = get_monotonic_time_us();
+        if (replay_first_timestamp > 0) {
+                if (realtime)
+                        shift_current_time((long) (replay_first_timestamp - (int64_t) get_current_time()));
+                else
+                        freeze_current_time(replay_first_timestamp);
+        }
+        return 1;
+}
+
+/**
+ * Wait up to timeout_ms for the next replayed message.
+ */
+static rd_kafka_message_t *replay_next_message(int timeout_ms) {
+        uint64_t pos = replay_pos;
+        const MSGLOG_ENTRY *entry = msglog_entry(replay_log, &pos);
+
+        if (!entry) {
+                if (replay_cnt >= 0) {
+                        fprintf(stderr, "%% Replayed %ld messages in %lld ms\n", replay_cnt,
+                                (get_monotonic_time_us() - replay_start_us) / 1000);
+                        replay_cnt = -1;
+                        all_caught_up = 1;
+                }
+                struct timespec idle = { .tv_sec = timeout_ms / 1000, .tv_nsec = (timeout_ms % 1000) * 1000000L };
+                nanosleep(&idle, NULL);
+                return NULL;
+        }
+
+        if (replay_realtime && replay_first_timestamp > 0 && entry->timestamp > 0) {
+                long long due_us = replay_start_us + (entry->timestamp - replay_first_timestamp) * 1000;
+                long long wait_us = due_us - get_monotonic_time_us();
+                if (wait_us > 0) {
+                        if (wait_us > timeout_ms * 1000LL) wait_us = timeout_ms * 1000LL;
+                        struct timespec pause = { .tv_sec = wait_us / 1000000, .tv_nsec = (wait_us % 1000000) * 1000 };
+                        nanosleep(&pause, NULL);
+                        if (due_us > get_monotonic_time_us())
+                                return NULL;
+                }
+        }
+        else if (!replay_realtime && entry->timestamp > 0) {
+                freeze_current_time(entry->timestamp);
+        }
+
+        KAFKA_REPLAYED_MESSAGE *message = calloc(1, sizeof *message);
+        if (!message)
+                return NULL;
+        message->rkm.partition = entry->partition;
+        message->rkm.offset = entry->offset;
+        message->rkm.key = (void *) msglog_entry_key(entry);
+        message->rkm.key_len = entry->key_len;
+        message->rkm.payload = (void *) msglog_entry_payload(entry);
+        message->rkm.len = entry->payload_len;
+        message->rkm._private = (void *) &replayed_marker;
+        message->topic = msglog_entry_topic(entry);
+        message->timestamp = entry->timestamp;
+
+        replay_pos = pos;
+        replay_cnt++;
+        return &message->rkm;
+}
+
+static int is_replayed(const rd_kafka_message_t *rkm) {
+        return rkm->_private == &replayed_marker;
+}
+
+/**
+ * rd_kafka_consumer_poll(), or the next message of the log while replaying.
+ */
+rd_kafka_message_t *kafka_consumer_poll(rd_kafka_t *rk, int timeout_ms) {
+        if (replay_log)
+                return replay_next_message(timeout_ms);
+        return rd_kafka_consumer_poll(rk, timeout_ms);
+}
+
+/**
+ * rd_kafka_message_destroy() for consumed as well as replayed messages.
+ */
+void kafka_message_destroy(rd_kafka_message_t *rkm) {
+        if (is_replayed(rkm))
+                free(rkm);
+        else
+                rd_kafka_message_destroy(rkm);
+}
+
+/**
+ * @returns the timestamp of a consumed or replayed message in ms, -1 if not available.
+ */
+int64_t kafka_message_timestamp(const rd_kafka_message_t *rkm) {
+        if (is_replayed(rkm))
+                return ((const KAFKA_REPLAYED_MESSAGE *) rkm)->timestamp;
+        return rd_kafka_message_timestamp(rkm, NULL);
+}
+
+/**
+ * @returns the topic of a consumed or replayed message.
+ */
+const char *kafka_message_topic(const rd_kafka_message_t *rkm) {
+        if (is_replayed(rkm))
+                return ((const KAFKA_REPLAYED_MESSAGE *) rkm)->topic;
+        return rd_kafka_topic_name(rkm->rkt);
+}
+
+/**
+ * Finish the message log being recorded or replayed. Replayed messages must have been destroyed.
+ */
+void kafka_close_logs(void) {
+        pthread_mutex_lock(&record_lock);
+        if (record_log) {
+                msglog_close(record_log);
+                record_log = NULL;
+        }
+        pthread_mutex_unlock(&record_lock);
+        if (replay_log) {
+                msglog_close(replay_log);
+                replay_log = NULL;
+        }
+}
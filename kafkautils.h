@@ -2,5 +2,54 @@
 #define _KAFKAUTILS_H_
 #include <librdkafka/rdkafka.h>
 
-rd_kafka_t *init_kafka_handler(const char *, const char *, int , char **);
+#define KAFKA_MAX_PARTITIONS 64
+#define KAFKA_MAX_TOPIC_LEN 128
+#define KAFKA_MAX_WORKERS 8
+
+/**
+ * Called for every consumed message. The handler owns the message and has to destroy it,
+ * after calling kafka_track_message() once the message has been applied.
+ */
+typedef void (*KAFKA_MESSAGE_HANDLER)(rd_kafka_t *, rd_kafka_message_t *, void *);
+
+/**
+ * Position of the consumer in a single partition.
+ */
+typedef struct KAFKA_OFFSET {
+	char topic[KAFKA_MAX_TOPIC_LEN];
+	int32_t partition;
+	int64_t offset;
+} KAFKA_OFFSET;
+
+/**
+ * Optional consumer behaviour, passed to init_kafka_handler().
+ * A zeroed struct gives the default behaviour (replay from the committed offset or from the earliest message).
+ */
+typedef struct KAFKA_OPTIONS {
+	int fast_start;   // on assignment rewind each partition to at most `history` messages before the high watermark
+	long history;     // amount of messages per partition needed to fill the screen
+	long max_lag;     // skip ahead when a partition falls more than this many messages behind (0 = never)
+	const KAFKA_OFFSET *initial_offsets; // start offsets overriding the committed ones, e.g. from a snapshot
+	int initial_offset_cnt;
+	int manual_offset_store; // offsets are only committed after kafka_store_offsets()
+	int workers;             // decode messages on this many threads, each owning a set of partitions (0 = consumer thread only)
+	KAFKA_MESSAGE_HANDLER handler; // required when workers > 0
+	void *handler_opaque;
+	int statistics_interval_ms; // publish librdkafka statistics as metrics this often (0 = off)
+	const char *record_path;    // append every tracked message to this message log (see msglog.h)
+} KAFKA_OPTIONS;
+
+rd_kafka_t *init_kafka_handler(const char *, const char *, int , char **, const KAFKA_OPTIONS *);
+void kafka_track_message(rd_kafka_t *, const rd_kafka_message_t *);
+int kafka_caught_up(void);
+int kafka_applied_offsets(KAFKA_OFFSET *, int);
+void kafka_store_offsets(rd_kafka_t *, const KAFKA_OFFSET *, int);
+void kafka_stop_workers(void);
+int kafka_pause(rd_kafka_t *, int);
+int kafka_start_replay(const char *, int);
+rd_kafka_message_t *kafka_consumer_poll(rd_kafka_t *, int);
+void kafka_message_destroy(rd_kafka_message_t *);
+int64_t kafka_message_timestamp(const rd_kafka_message_t *);
+const char *kafka_message_topic(const rd_kafka_message_t *);
+void kafka_close_logs(void);
 #endif
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <librdkafka/rdkafka.h>
+#include "latency.h"
+#include "metrics.h"
+#include "timeops.h"
+#include "kafkautils.h"
+
+/* The on-screen p99 covers the updates displayed since it was last refreshed, at least this many */
+#define P99_MIN_SAMPLES 20
+
+/**
+ * Stamp a message as consumed now and count how long it took from the producer to here.
+ * The producer timestamp is on the wall clock of the producing host, so clock skew between
+ * hosts shows up in this stage; ages below zero are counted as zero.
+ */
+void latency_consumed(LATENCY_TRACE *trace, const rd_kafka_message_t *rkm)
+{
+	int64_t produced_ms = kafka_message_timestamp(rkm);
+
+	trace->consumed_us = get_monotonic_time_us();
+	trace->produced_us = 0;
+	if (produced_ms < 0) return;
+
+	long long age_us = ((long long) get_current_time() - produced_ms) * 1000;
+	if (age_us < 0) age_us = 0;
+	trace->produced_us = trace->consumed_us - age_us;
+	metrics_observe(HISTOGRAM_PRODUCE_TO_CONSUME_US, age_us);
+}
+
+/**
+ * Fold an update into the ones waiting for the next frame, keeping the oldest stamps:
+ * the frame is as stale as the oldest update it shows for the first time.
+ */
+void latency_merge(LATENCY_TRACE *pending, const LATENCY_TRACE *trace)
+{
+	if (!trace->consumed_us) return;
+	if (!pending->consumed_us || trace->consumed_us < pending->consumed_us)
+		pending->consumed_us = trace->consumed_us;
+	if (trace->produced_us && (!pending->produced_us || trace->produced_us < pending->produced_us))
+		pending->produced_us = trace->produced_us;
+}
+
+/**
+ * Count the remaining stages of a pending update once a frame showing it was flushed to the display.
+ * render_us is when the frame was started, glass_us when the SPI transfer of it completed.
+ */
+void latency_displayed(LATENCY_TRACE *pending, long long render_us, long long glass_us)
+{
+	if (!pending->consumed_us) return;
+
+	metrics_observe(HISTOGRAM_CONSUME_TO_RENDER_US, render_us - pending->consumed_us);
+	metrics_observe(HISTOGRAM_RENDER_TO_GLASS_US, glass_us - render_us);
+	if (pending->produced_us)
+		metrics_observe(HISTOGRAM_PRODUCE_TO_GLASS_US, glass_us - pending->produced_us);
+
+	pending->consumed_us = 0;
+	pending->produced_us = 0;
+}
+
+/**
+ * Format the p99 produce-to-glass latency of recently displayed updates, e.g. "p99 250ms".
+ * The value is the upper bound of the bucket holding the 99th percentile. It is refreshed once
+ * enough updates were displayed since the previous refresh, otherwise the previous value is kept.
+ *
+ * @returns 1 if text was written, 0 if nothing was measured yet.
+ */
+int latency_describe_p99(char *text, size_t size)
+{
+	static long previous_counts[HISTOGRAM_BUCKETS + 1];
+	static int p99_bucket = -1;
+	long counts[HISTOGRAM_BUCKETS + 1];
+	long total = 0;
+
+	metrics_histogram_counts(HISTOGRAM_PRODUCE_TO_GLASS_US, counts);
+	for (int i = 0; i <= HISTOGRAM_BUCKETS; i++) total += counts[i] - previous_counts[i];
+
+	if (total >= P99_MIN_SAMPLES || (p99_bucket < 0 && total > 0)) {
+		long threshold = total - total / 100, seen = 0;
+		p99_bucket = 0;
+		while (p99_bucket < HISTOGRAM_BUCKETS && (seen += counts[p99_bucket] - previous_counts[p99_bucket]) < threshold)
+			p99_bucket++;
+		for (int i = 0; i <= HISTOGRAM_BUCKETS; i++) previous_counts[i] = counts[i];
+	}
+	if (p99_bucket < 0) return 0;
+
+	/* The last bucket has no upper bound, show its lower one instead */
+	int overflow = p99_bucket == HISTOGRAM_BUCKETS;
+	long p99_us = metrics_histogram_bound(overflow ? HISTOGRAM_BUCKETS - 1 : p99_bucket);
+	if (p99_us < 1000000)
+		snprintf(text, size, "p99 %s%ldms", overflow ? ">" : "", (p99_us + 999) / 1000);
+	else
+		snprintf(text, size, "p99 %s%.1fs", overflow ? ">" : "", p99_us / 1000000.0f);
+	return 1;
+}
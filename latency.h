@@ -0,0 +1,19 @@
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+#include <stddef.h>
+#include <librdkafka/rdkafka.h>
+
+/**
+ * Stage timestamps of a displayed update on the monotonic clock (see get_monotonic_time_us).
+ * A zero consumed_us means there is no update waiting to reach the screen.
+ */
+typedef struct LATENCY_TRACE {
+	long long produced_us;  // producer timestamp translated to the monotonic clock, 0 if unknown
+	long long consumed_us;  // time the message was consumed
+} LATENCY_TRACE;
+
+void latency_consumed(LATENCY_TRACE *, const rd_kafka_message_t *);
+void latency_merge(LATENCY_TRACE *, const LATENCY_TRACE *);
+void latency_displayed(LATENCY_TRACE *, long long, long long);
+int latency_describe_p99(char *, size_t);
+#endif
@@ -0,0 +1,49 @@
+#include <string.h>
+#include "logview.h"
+
+/**
+ * Rasterize ring slot `line` into its framebuffer rows.
+ */
+static void draw_line(const LOGVIEW *log, int line, unsigned short rgb)
+{
+	int row = line * LOGVIEW_LINE_HEIGHT;
+	SSD1331_clear_rows(row, LOGVIEW_LINE_HEIGHT);
+	SSD1331_string53(0, row + 1, log->lines[line], 2, 1, rgb);
+}
+
+/**
+ * Empty the log and the panel, with the display start line back at the top of the display RAM.
+ */
+void logview_init(LOGVIEW *log)
+{
+	memset(log, 0, sizeof *log);
+	SSD1331_clear();
+	SSD1331_display();
+	SSD1331_start_line(0);
+}
+
+/**
+ * Add a message at the bottom of the log, wrapped into as many lines as it needs up to a screen full.
+ * Each line costs one SPI transfer of its own rows; the older lines move up by moving the start line.
+ */
+void logview_append(LOGVIEW *log, const char *text, size_t len, unsigned short rgb)
+{
+	size_t offset = 0;
+
+	do {
+		size_t chunk = len - offset < LOGVIEW_LINE_CHARS ? len - offset : LOGVIEW_LINE_CHARS;
+		int line = log->head;
+
+		memcpy(log->lines[line], text + offset, chunk);
+		log->lines[line][chunk] = '\0';
+		draw_line(log, line, rgb);
+		SSD1331_display_rows(line * LOGVIEW_LINE_HEIGHT, LOGVIEW_LINE_HEIGHT);
+
+		log->head = (line + 1) % LOGVIEW_LINES;
+		if (log->count < LOGVIEW_LINES) log->count++;
+
+		/* The line after the newest one is the oldest, it goes to the top of the panel */
+		SSD1331_start_line(log->head * LOGVIEW_LINE_HEIGHT);
+		offset += chunk;
+	} while (offset < len && offset < LOGVIEW_LINES * LOGVIEW_LINE_CHARS);
+}
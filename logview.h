@@ -0,0 +1,23 @@
+#ifndef _LOGVIEW_H_
+#define _LOGVIEW_H_
+#include <stddef.h>
+#include "ssd1331.h"
+
+#define LOGVIEW_LINE_HEIGHT 8
+#define LOGVIEW_LINES (OLED_HEIGHT / LOGVIEW_LINE_HEIGHT)
+#define LOGVIEW_LINE_CHARS (OLED_WIDTH / 4) // characters of the 5x3 font per line
+
+/**
+ * Scrolling log of the latest messages. Line i of the ring is kept in display RAM rows
+ * i * LOGVIEW_LINE_HEIGHT onwards, so a new line only sends its own rows to the panel
+ * and scrolling moves the display start line instead of sending the other lines again.
+ */
+typedef struct LOGVIEW {
+	char lines[LOGVIEW_LINES][LOGVIEW_LINE_CHARS + 1];
+	int head;  // ring slot the next line is written to
+	int count;
+} LOGVIEW;
+
+void logview_init(LOGVIEW *);
+void logview_append(LOGVIEW *, const char *, size_t, unsigned short);
+#endif
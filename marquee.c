@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1331.h"
+#include "marquee.h"
+
+static int text_width(const MARQUEE *marquee, const char *text, size_t len)
+{
+	return marquee->font ? psf_text_width(marquee->font, text, len) : (int) len * (MARQUEE_SIZE / 2);
+}
+
+static int draw_text(MARQUEE *marquee, int x, const char *text, size_t len, unsigned short rgb)
+{
+	if (marquee->font) return psf_text_strip(marquee->font, marquee->strip, marquee->capacity, x, text, len, rgb);
+	return SSD1331_text_strip(marquee->strip, marquee->capacity, x, text, len, MARQUEE_SIZE, rgb);
+}
+
+/**
+ * Rasterize `text` between `prefix` and `suffix` into the strip, growing it when needed, and start showing it
+ * from the beginning. The text is read where it is, it can be of any length. A text wider than
+ * MARQUEE_MAX_STRIP_KB allows is cut off, without the suffix.
+ * The text is UTF-8 when a font file is set and ASCII for the built-in font.
+ *
+ * @returns 1 on success, -1 if out of memory (the previous text stays).
+ */
+int marquee_set(MARQUEE *marquee, const char *prefix, const char *text, size_t len, const char *suffix, unsigned short rgb)
+{
+	int height = marquee->font ? (int) marquee->font->height : MARQUEE_SIZE;
+	int max_width = MARQUEE_MAX_STRIP_KB * 1024 / (height * 2);
+	long width = (long) text_width(marquee, prefix, strlen(prefix)) + text_width(marquee, text, len)
+	           + text_width(marquee, suffix, strlen(suffix));
+	int cut = width > max_width;
+	if (cut) width = max_width;
+
+	if (width > 0 && (width > marquee->capacity || height != marquee->height)) {
+		unsigned char *strip = realloc(marquee->strip, (size_t) width * height * 2);
+		if (!strip) return -1;
+		marquee->strip = strip;
+		marquee->capacity = width;
+		marquee->height = height;
+	}
+
+	int x = 0;
+	if (marquee->strip) {
+		x = draw_text(marquee, x, prefix, strlen(prefix), rgb);
+		x = draw_text(marquee, x, text, len, rgb);
+		if (!cut) x = draw_text(marquee, x, suffix, strlen(suffix), rgb);
+	}
+	marquee->width = x;
+	marquee->shown_ms = 0;
+	return 1;
+}
+
+void marquee_advance(MARQUEE *marquee, long elapsed_ms)
+{
+	marquee->shown_ms += elapsed_ms;
+}
+
+/**
+ * Copy the visible part of the text to row y of the screen. A text wider than the screen runs from right to left
+ * and starts over after a gap.
+ */
+void marquee_draw(const MARQUEE *marquee, int y)
+{
+	if (marquee->width <= OLED_WIDTH) {
+		SSD1331_blit(0, y, marquee->strip, marquee->capacity, 0, marquee->width, marquee->height);
+		return;
+	}
+
+	int period = marquee->width + MARQUEE_GAP;
+	long scroll_ms = marquee->shown_ms > MARQUEE_HOLD_MS ? marquee->shown_ms - MARQUEE_HOLD_MS : 0;
+	int offset = (int) ((long long) scroll_ms * MARQUEE_SPEED / 1000 % period);
+
+	if (offset < marquee->width) {
+		SSD1331_blit(0, y, marquee->strip, marquee->capacity, offset, marquee->width - offset, marquee->height);
+	}
+	if (period - offset < OLED_WIDTH) {
+		SSD1331_blit(period - offset, y, marquee->strip, marquee->capacity, 0, OLED_WIDTH - (period - offset), marquee->height);
+	}
+}
+
+void marquee_free(MARQUEE *marquee)
+{
+	free(marquee->strip);
+	marquee->strip = NULL;
+	marquee->capacity = marquee->width = marquee->height = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef _MARQUEE_H_
+#define _MARQUEE_H_
+#include <stddef.h>
+#include "psffont.h"
+
+#define MARQUEE_SIZE 12           // size of the built-in font, also the height of the strip when no font file is used
+#define MARQUEE_MAX_STRIP_KB 1024 // memory bound of the strip, a text wider than it is cut off at its end
+#define MARQUEE_GAP 24            // pixels between the end of the text and its next repetition
+#define MARQUEE_SPEED 30          // pixels per second
+#define MARQUEE_HOLD_MS 1500      // time the start of a new text stands still before it scrolls
+
+/**
+ * Text rasterized once into an off-screen strip. A text wider than the screen scrolls by copying
+ * a moving window of the strip, so frames do not decode glyphs. The strip grows with the text
+ * up to MARQUEE_MAX_STRIP_KB, about 7000 characters of the built-in font.
+ */
+typedef struct MARQUEE {
+	unsigned char *strip; // RGB565 in framebuffer byte order, `height` rows of `capacity` pixels
+	PSF_FONT *font;       // font file the text is drawn with, NULL for the built-in ASCII font
+	int height;
+	int capacity;
+	int width;            // width of the rasterized text
+	long shown_ms;        // time the text is shown
+} MARQUEE;
+
+int marquee_set(MARQUEE *, const char *, const char *, size_t, const char *, unsigned short);
+void marquee_advance(MARQUEE *, long);
+void marquee_draw(const MARQUEE *, int);
+void marquee_free(MARQUEE *);
+#endif
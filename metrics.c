@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include "metrics.h"
+
+static const char *metric_names[METRIC_COUNT] = {
+	[METRIC_MESSAGES_CONSUMED]              = "oled_messages_consumed_total",
+	[METRIC_FRAMES_RENDERED]                = "oled_frames_rendered_total",
+	[METRIC_TIME_TO_FIRST_CORRECT_FRAME_MS] = "oled_time_to_first_correct_frame_ms",
+	[METRIC_LAG_SKIPS]                      = "oled_lag_skips_total",
+	[METRIC_LATE_SAMPLES]                   = "oled_late_samples_total",
+	[METRIC_CHART_ADVANCES]                 = "oled_chart_advances_total",
+	[METRIC_HANDOFF_DEPTH]                  = "oled_handoff_depth",
+	[METRIC_HANDOFF_COALESCED]              = "oled_handoff_coalesced_total",
+	[METRIC_HANDOFF_DROPPED]                = "oled_handoff_dropped_total",
+	[METRIC_PAUSES]                         = "oled_partition_pauses_total",
+	[METRIC_RESUMES]                        = "oled_partition_resumes_total",
+	[METRIC_MESSAGES_PRODUCED]              = "oled_messages_produced_total",
+	[METRIC_DELIVERY_FAILURES]              = "oled_delivery_failures_total",
+	[METRIC_SAMPLES_DROPPED]                = "oled_samples_dropped_total",
+	[METRIC_DELIVERY_LATENCY_AVG_US]        = "oled_delivery_latency_avg_us",
+	[METRIC_DELIVERY_LATENCY_MAX_US]        = "oled_delivery_latency_max_us",
+	[METRIC_STATISTICS_RECEIVED]            = "oled_kafka_statistics_total",
+	[METRIC_BROKER_RTT_US]                  = "oled_kafka_broker_rtt_avg_us",
+	[METRIC_CONSUMER_LAG]                   = "oled_kafka_consumer_lag",
+	[METRIC_CONSUMER_LAG_MAX]               = "oled_kafka_consumer_lag_max",
+	[METRIC_FETCH_QUEUE_MESSAGES]           = "oled_kafka_fetch_queue_messages",
+	[METRIC_REBALANCES]                     = "oled_kafka_rebalances_total",
+	[METRIC_FRAME_BYTES]                    = "oled_frame_bytes_total",
+	[METRIC_IDLE]                           = "oled_idle",
+	[METRIC_IDLE_ENTERED]                   = "oled_idle_entered_total",
+	[METRIC_IDLE_MS]                        = "oled_idle_ms_total",
+};
+
+static const char *histogram_names[HISTOGRAM_COUNT] = {
+	[HISTOGRAM_PRODUCE_TO_CONSUME_US] = "oled_produce_to_consume_us",
+	[HISTOGRAM_CONSUME_TO_RENDER_US]  = "oled_consume_to_render_us",
+	[HISTOGRAM_RENDER_TO_GLASS_US]    = "oled_render_to_glass_us",
+	[HISTOGRAM_PRODUCE_TO_GLASS_US]   = "oled_produce_to_glass_us",
+};
+
+/* Upper bounds of the histogram buckets, from a fraction of an SPI flush up to a minute of staleness */
+static const long histogram_bounds[HISTOGRAM_BUCKETS] = {
+	500, 1000, 2500, 5000, 10000, 25000, 50000, 100000,
+	250000, 500000, 1000000, 2500000, 5000000, 10000000, 30000000, 60000000
+};
+
+/* Values are updated from the consumer and render threads, so all access is atomic */
+static long metric_values[METRIC_COUNT];
+static long histogram_counts[HISTOGRAM_COUNT][HISTOGRAM_BUCKETS + 1];
+static long long histogram_sums[HISTOGRAM_COUNT]; // 64 bit, microseconds add up quickly
+
+void metrics_add(METRIC_ID id, long value) {
+	__atomic_add_fetch(&metric_values[id], value, __ATOMIC_RELAXED);
+}
+
+void metrics_set(METRIC_ID id, long value) {
+	__atomic_store_n(&metric_values[id], value, __ATOMIC_RELAXED);
+}
+
+long metrics_get(METRIC_ID id) {
+	return __atomic_load_n(&metric_values[id], __ATOMIC_RELAXED);
+}
+
+/**
+ * Count a value into the first bucket whose bound it does not exceed.
+ */
+void metrics_observe(HISTOGRAM_ID id, long value) {
+	int bucket = 0;
+	while (bucket < HISTOGRAM_BUCKETS && value > histogram_bounds[bucket]) bucket++;
+	__atomic_add_fetch(&histogram_counts[id][bucket], 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&histogram_sums[id], value, __ATOMIC_RELAXED);
+}
+
+/**
+ * Copy the (non-cumulative) bucket counts of a histogram into counts[HISTOGRAM_BUCKETS + 1].
+ */
+void metrics_histogram_counts(HISTOGRAM_ID id, long *counts) {
+	for (int i = 0; i <= HISTOGRAM_BUCKETS; i++)
+		counts[i] = __atomic_load_n(&histogram_counts[id][i], __ATOMIC_RELAXED);
+}
+
+/**
+ * @returns the upper bound of a finite bucket.
+ */
+long metrics_histogram_bound(int bucket) {
+	return histogram_bounds[bucket];
+}
+
+/**
+ * Write all metrics to the given path in the Prometheus text format.
+ * The file is written next to the target and renamed over it, so readers never see a partial file.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int metrics_export(const char *path) {
+	char tmp_path[256];
+	FILE *file;
+
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+	file = fopen(tmp_path, "w");
+	if (!file) return -1;
+
+	for (int i = 0; i < METRIC_COUNT; i++) {
+		fprintf(file, "%s %ld\n", metric_names[i], metrics_get(i));
+	}
+	for (int i = 0; i < HISTOGRAM_COUNT; i++) {
+		long counts[HISTOGRAM_BUCKETS + 1];
+		long cumulative = 0;
+
+		metrics_histogram_counts(i, counts);
+		fprintf(file, "# TYPE %s histogram\n", histogram_names[i]);
+		for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+			cumulative += counts[bucket];
+			fprintf(file, "%s_bucket{le=\"%ld\"} %ld\n", histogram_names[i], histogram_bounds[bucket], cumulative);
+		}
+		cumulative += counts[HISTOGRAM_BUCKETS];
+		fprintf(file, "%s_bucket{le=\"+Inf\"} %ld\n", histogram_names[i], cumulative);
+		fprintf(file, "%s_sum %lld\n", histogram_names[i], __atomic_load_n(&histogram_sums[i], __ATOMIC_RELAXED));
+		fprintf(file, "%s_count %ld\n", histogram_names[i], cumulative);
+	}
+	if (fclose(file) != 0) return -1;
+
+	return rename(tmp_path, path) == 0 ? 1 : -1;
+}
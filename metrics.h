@@ -0,0 +1,60 @@
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+/**
+ * Process-wide counters and gauges.
+ * Add new entries before METRIC_COUNT and give them a name in metrics.c.
+ */
+typedef enum METRIC_ID {
+	METRIC_MESSAGES_CONSUMED,
+	METRIC_FRAMES_RENDERED,
+	METRIC_TIME_TO_FIRST_CORRECT_FRAME_MS,
+	METRIC_LAG_SKIPS,
+	METRIC_LATE_SAMPLES,
+	METRIC_CHART_ADVANCES,
+	METRIC_HANDOFF_DEPTH,
+	METRIC_HANDOFF_COALESCED,
+	METRIC_HANDOFF_DROPPED,
+	METRIC_PAUSES,
+	METRIC_RESUMES,
+	METRIC_MESSAGES_PRODUCED,
+	METRIC_DELIVERY_FAILURES,
+	METRIC_SAMPLES_DROPPED,
+	METRIC_DELIVERY_LATENCY_AVG_US,
+	METRIC_DELIVERY_LATENCY_MAX_US,
+	METRIC_STATISTICS_RECEIVED,
+	METRIC_BROKER_RTT_US,
+	METRIC_CONSUMER_LAG,
+	METRIC_CONSUMER_LAG_MAX,
+	METRIC_FETCH_QUEUE_MESSAGES,
+	METRIC_REBALANCES,
+	METRIC_FRAME_BYTES,
+	METRIC_IDLE,
+	METRIC_IDLE_ENTERED,
+	METRIC_IDLE_MS,
+	METRIC_COUNT
+} METRIC_ID;
+
+/**
+ * Process-wide latency histograms in microseconds, exported in the Prometheus histogram format.
+ * Add new entries before HISTOGRAM_COUNT and give them a name in metrics.c.
+ */
+typedef enum HISTOGRAM_ID {
+	HISTOGRAM_PRODUCE_TO_CONSUME_US,
+	HISTOGRAM_CONSUME_TO_RENDER_US,
+	HISTOGRAM_RENDER_TO_GLASS_US,
+	HISTOGRAM_PRODUCE_TO_GLASS_US,
+	HISTOGRAM_COUNT
+} HISTOGRAM_ID;
+
+/* Finite bucket bounds; one more bucket counts everything above the last bound */
+#define HISTOGRAM_BUCKETS 16
+
+void metrics_add(METRIC_ID, long);
+void metrics_set(METRIC_ID, long);
+long metrics_get(METRIC_ID);
+void metrics_observe(HISTOGRAM_ID, long);
+void metrics_histogram_counts(HISTOGRAM_ID, long *);
+long metrics_histogram_bound(int);
+int metrics_export(const char *);
+#endif
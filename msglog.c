@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "msglog.h"
+
+#define MSGLOG_INITIAL_CAPACITY (1 << 20)
+#define MSGLOG_ALIGN(size) (((size) + 7) & ~(size_t) 7)
+
+static MSGLOG_HEADER *msglog_header(const MSGLOG *log)
+{
+	return (MSGLOG_HEADER *) log->base;
+}
+
+/**
+ * Grow the file and its mapping so that at least `needed` bytes fit.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+static int msglog_reserve(MSGLOG *log, size_t needed)
+{
+	size_t capacity = log->capacity;
+	if (needed <= capacity) return 1;
+
+	while (capacity < needed) capacity *= 2;
+	if (munmap(log->base, log->capacity) < 0 || ftruncate(log->fd, capacity) < 0) {
+		log->base = MAP_FAILED;
+		return -1;
+	}
+	log->base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, log->fd, 0);
+	if (log->base == MAP_FAILED) return -1;
+	log->capacity = capacity;
+	return 1;
+}
+
+/**
+ * Create (or truncate) a log at the given path for appending.
+ *
+ * @returns pointer to the log, or NULL on failure.
+ */
+MSGLOG *msglog_create(const char *path)
+{
+	MSGLOG *log = malloc(sizeof *log);
+	if (!log) return NULL;
+
+	log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (log->fd < 0 || ftruncate(log->fd, MSGLOG_INITIAL_CAPACITY) < 0) {
+		perror("msglog");
+		if (log->fd >= 0) close(log->fd);
+		free(log);
+		return NULL;
+	}
+
+	log->base = mmap(NULL, MSGLOG_INITIAL_CAPACITY, PROT_READ | PROT_WRITE, MAP_SHARED, log->fd, 0);
+	if (log->base == MAP_FAILED) {
+		perror("msglog");
+		close(log->fd);
+		free(log);
+		return NULL;
+	}
+	log->capacity = MSGLOG_INITIAL_CAPACITY;
+	log->writable = 1;
+	pthread_mutex_init(&log->lock, NULL);
+
+	MSGLOG_HEADER *header = msglog_header(log);
+	header->magic = MSGLOG_MAGIC;
+	header->version = MSGLOG_VERSION;
+	header->end = sizeof(MSGLOG_HEADER);
+
+	return log;
+}
+
+/**
+ * Open an existing log for reading.
+ *
+ * @returns pointer to the log, or NULL if it cannot be read or is not a message log.
+ */
+MSGLOG *msglog_open(const char *path)
+{
+	struct stat st;
+	MSGLOG *log = malloc(sizeof *log);
+	if (!log) return NULL;
+
+	log->fd = open(path, O_RDONLY);
+	if (log->fd < 0 || fstat(log->fd, &st) < 0 || st.st_size < (off_t) sizeof(MSGLOG_HEADER)) {
+		fprintf(stderr, "%s is not a message log.\n", path);
+		if (log->fd >= 0) close(log->fd);
+		free(log);
+		return NULL;
+	}
+
+	log->base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, log->fd, 0);
+	if (log->base == MAP_FAILED) {
+		perror("msglog");
+		close(log->fd);
+		free(log);
+		return NULL;
+	}
+	log->capacity = st.st_size;
+	log->writable = 0;
+	pthread_mutex_init(&log->lock, NULL);
+
+	const MSGLOG_HEADER *header = msglog_header(log);
+	if (header->magic != MSGLOG_MAGIC || header->version != MSGLOG_VERSION || header->end > log->capacity) {
+		fprintf(stderr, "%s is not a message log.\n", path);
+		msglog_close(log);
+		return NULL;
+	}
+
+	return log;
+}
+
+/**
+ * Append a message. Safe to call from several threads.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int msglog_append(MSGLOG *log, const char *topic, int32_t partition, int64_t offset, int64_t timestamp,
+		const void *key, size_t key_len, const void *payload, size_t payload_len)
+{
+	size_t topic_len = strlen(topic);
+	size_t size = MSGLOG_ALIGN(sizeof(MSGLOG_ENTRY) + topic_len + 1 + key_len + payload_len);
+
+	pthread_mutex_lock(&log->lock);
+	if (log->base == MAP_FAILED || msglog_reserve(log, msglog_header(log)->end + size) < 0) {
+		pthread_mutex_unlock(&log->lock);
+		return -1;
+	}
+
+	MSGLOG_HEADER *header = msglog_header(log);
+	MSGLOG_ENTRY *entry = (MSGLOG_ENTRY *) (log->base + header->end);
+	entry->size = size;
+	entry->partition = partition;
+	entry->offset = offset;
+	entry->timestamp = timestamp;
+	entry->topic_len = topic_len;
+	entry->flags = key ? MSGLOG_HAS_KEY : 0;
+	entry->key_len = key ? key_len : 0;
+	entry->payload_len = payload ? payload_len : 0;
+	entry->reserved = 0;
+
+	unsigned char *data = (unsigned char *) (entry + 1);
+	memcpy(data, topic, topic_len + 1);
+	if (key) memcpy(data + topic_len + 1, key, key_len);
+	if (payload) memcpy(data + topic_len + 1 + entry->key_len, payload, payload_len);
+
+	/* Publish the record only once it is complete */
+	__atomic_store_n(&header->end, header->end + size, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&log->lock);
+	return 1;
+}
+
+/**
+ * Read the record at *pos and advance *pos to the next one.
+ *
+ * @returns the record, or NULL at the end of the log (or at a damaged record).
+ */
+const MSGLOG_ENTRY *msglog_entry(const MSGLOG *log, uint64_t *pos)
+{
+	uint64_t end = msglog_header(log)->end;
+	if (*pos < sizeof(MSGLOG_HEADER)) *pos = sizeof(MSGLOG_HEADER);
+	if (*pos + sizeof(MSGLOG_ENTRY) > end) return NULL;
+
+	const MSGLOG_ENTRY *entry = (const MSGLOG_ENTRY *) (log->base + *pos);
+	if (entry->size < sizeof(MSGLOG_ENTRY) || *pos + entry->size > end ||
+	    sizeof(MSGLOG_ENTRY) + (uint64_t) entry->topic_len + 1 + entry->key_len + entry->payload_len > entry->size)
+		return NULL;
+
+	*pos += entry->size;
+	return entry;
+}
+
+/**
+ * @returns the topic of a record, NUL-terminated.
+ */
+const char *msglog_entry_topic(const MSGLOG_ENTRY *entry)
+{
+	return (const char *) (entry + 1);
+}
+
+/**
+ * @returns the key of a record, NULL if the message had none.
+ */
+const void *msglog_entry_key(const MSGLOG_ENTRY *entry)
+{
+	return entry->flags & MSGLOG_HAS_KEY ? msglog_entry_topic(entry) + entry->topic_len + 1 : NULL;
+}
+
+const void *msglog_entry_payload(const MSGLOG_ENTRY *entry)
+{
+	return msglog_entry_topic(entry) + entry->topic_len + 1 + entry->key_len;
+}
+
+/**
+ * Close the log. A log opened for appending is cut down to the records written.
+ */
+void msglog_close(MSGLOG *log)
+{
+	if (log->base != MAP_FAILED) {
+		uint64_t end = msglog_header(log)->end;
+		munmap(log->base, log->capacity);
+		if (log->writable && ftruncate(log->fd, end) < 0) perror("msglog");
+	}
+	close(log->fd);
+	pthread_mutex_destroy(&log->lock);
+	free(log);
+}
@@ -0,0 +1,55 @@
+#ifndef _MSGLOG_H_
+#define _MSGLOG_H_
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#define MSGLOG_MAGIC 0x474F4C4D // "MLOG"
+#define MSGLOG_VERSION 1
+#define MSGLOG_HAS_KEY 0x1
+
+/**
+ * File header. `end` is only advanced once a record has been written completely,
+ * so a log cut short by a crash still reads back up to its last complete record.
+ */
+typedef struct MSGLOG_HEADER {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t end;
+} MSGLOG_HEADER;
+
+/**
+ * A recorded message, followed by the NUL-terminated topic, key and payload and padded to 8 bytes.
+ */
+typedef struct MSGLOG_ENTRY {
+	uint32_t size;         // of the whole record including padding
+	int32_t partition;
+	int64_t offset;
+	int64_t timestamp;     // message timestamp in ms, -1 if not available
+	uint16_t topic_len;
+	uint16_t flags;
+	uint32_t key_len;
+	uint32_t payload_len;
+	uint32_t reserved;
+} MSGLOG_ENTRY;
+
+/**
+ * Memory-mapped message log, either opened for appending or for reading.
+ */
+typedef struct MSGLOG {
+	int fd;
+	unsigned char *base;
+	size_t capacity;  // mapped size
+	int writable;
+	pthread_mutex_t lock;
+} MSGLOG;
+
+MSGLOG *msglog_create(const char *);
+MSGLOG *msglog_open(const char *);
+int msglog_append(MSGLOG *, const char *, int32_t, int64_t, int64_t, const void *, size_t, const void *, size_t);
+const MSGLOG_ENTRY *msglog_entry(const MSGLOG *, uint64_t *);
+const char *msglog_entry_topic(const MSGLOG_ENTRY *);
+const void *msglog_entry_key(const MSGLOG_ENTRY *);
+const void *msglog_entry_payload(const MSGLOG_ENTRY *);
+void msglog_close(MSGLOG *);
+#endif
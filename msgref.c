@@ -0,0 +1,52 @@
+#include <stdlib.h>
+#include <string.h>
+#include "msgref.h"
+#include "kafkautils.h"
+
+/**
+ * Wrap a message into a handle holding one reference. The handle takes ownership of the message.
+ *
+ * @returns the handle, or NULL if out of memory (the message is destroyed then).
+ */
+MESSAGE_REF *msgref_new(rd_kafka_message_t *rkm)
+{
+	MESSAGE_REF *ref = malloc(sizeof *ref);
+	if (!ref) {
+		kafka_message_destroy(rkm);
+		return NULL;
+	}
+
+	ref->rkm = rkm;
+	ref->key = (const char *) rkm->key;
+	ref->key_len = rkm->key_len;
+	ref->payload = (const char *) rkm->payload;
+	ref->len = rkm->len;
+	ref->trace.produced_us = 0;
+	ref->trace.consumed_us = 0;
+	ref->refs = 1;
+
+	return ref;
+}
+
+MESSAGE_REF *msgref_retain(MESSAGE_REF *ref)
+{
+	if (ref) __atomic_add_fetch(&ref->refs, 1, __ATOMIC_RELAXED);
+	return ref;
+}
+
+void msgref_release(MESSAGE_REF *ref)
+{
+	if (!ref || __atomic_sub_fetch(&ref->refs, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	if (ref->rkm) kafka_message_destroy(ref->rkm);
+	free(ref);
+}
+
+/**
+ * @returns 1 if both messages carry the same key (or both none), else 0.
+ */
+int msgref_same_key(const MESSAGE_REF *a, const MESSAGE_REF *b)
+{
+	if (a->key_len != b->key_len || !a->key != !b->key) return 0;
+	return a->key_len == 0 || memcmp(a->key, b->key, a->key_len) == 0;
+}
@@ -0,0 +1,25 @@
+#ifndef _MSGREF_H_
+#define _MSGREF_H_
+#include <librdkafka/rdkafka.h>
+#include "latency.h"
+
+/**
+ * Reference-counted handle to a consumed message.
+ * Key and payload point into the message itself, nothing is copied.
+ * The message is destroyed when the last reference is released.
+ */
+typedef struct MESSAGE_REF {
+	rd_kafka_message_t *rkm;
+	const char *key;
+	size_t key_len;
+	const char *payload;
+	size_t len;
+	LATENCY_TRACE trace;  // when the message was produced and consumed
+	int refs;
+} MESSAGE_REF;
+
+MESSAGE_REF *msgref_new(rd_kafka_message_t *);
+MESSAGE_REF *msgref_retain(MESSAGE_REF *);
+void msgref_release(MESSAGE_REF *);
+int msgref_same_key(const MESSAGE_REF *, const MESSAGE_REF *);
+#endif
@@ -0,0 +1,106 @@
+#ifndef _PANEL_H_
+#define _PANEL_H_
+
+/*
+ * Compile-time description of the display panel, selected with -DPANEL_<name> (make PANEL=<name>).
+ * Everything is a constant, so framebuffer index calculations fold at compile time and the driver
+ * carries no code for panels it is not built for.
+ *
+ *   PANEL_NAME               controller name
+ *   OLED_WIDTH, OLED_HEIGHT  geometry in pixels; the height is a power of two, the display start line wraps at it
+ *   PANEL_BYTES_PER_PIXEL    framebuffer format, RGB565 with the high byte first on both panels
+ *   PANEL_SPI_HZ             SPI clock
+ *   PANEL_ARGS_AS_DATA       command arguments are sent with D/C high (1) or low like the command itself (0)
+ *   PANEL_WRITE_RAM          command that has to precede pixel data, 0 if none
+ *   PANEL_HAS_DRAW_COMMANDS  the controller can draw lines on its own
+ *   PANEL_INIT               init sequence of entries: command, argument count, arguments
+ *   PANEL_DIM, PANEL_BRIGHT  sequences in the same format that dim the panel and restore full brightness
+ *   PANEL_REMAP_256          SET_REMAP value of PANEL_INIT with the 256 colour (RGB332) format, 0 if there is none
+ */
+
+#if defined(PANEL_SSD1351)
+
+#define SSD1351_WRITE_RAM               0x5C
+#define SSD1351_NORMAL_DISPLAY          0xA6
+#define SSD1351_FUNCTION_SELECT         0xAB
+#define SSD1351_SET_VSL                 0xB4
+#define SSD1351_SET_GPIO                0xB5
+#define SSD1351_SET_SECOND_PRECHARGE    0xB6
+#define SSD1351_SET_CONTRAST_ABC        0xC1
+#define SSD1351_MASTER_CONTRAST         0xC7
+#define SSD1351_SET_MULTIPLEX_RATIO     0xCA
+#define SSD1351_COMMAND_LOCK            0xFD
+
+#define PANEL_NAME "SSD1351"
+#define OLED_WIDTH 128
+#define OLED_HEIGHT 128
+#define PANEL_BYTES_PER_PIXEL 2
+#define PANEL_SPI_HZ 8000000           // 32 KB frames, the controller takes up to 20 MHz
+#define PANEL_ARGS_AS_DATA 1
+#define PANEL_WRITE_RAM SSD1351_WRITE_RAM
+#define PANEL_HAS_DRAW_COMMANDS 0
+#define PANEL_REMAP_256 0
+#define PANEL_INIT \
+	SSD1351_COMMAND_LOCK, 1, 0x12,              /* unlock the driver */ \
+	SSD1351_COMMAND_LOCK, 1, 0xB1,              /* make the commands below accessible */ \
+	DISPLAY_OFF, 0, \
+	DISPLAY_CLOCK_DIV, 1, 0xF1, \
+	SSD1351_SET_MULTIPLEX_RATIO, 1, OLED_HEIGHT - 1, \
+	SET_REMAP, 1, 0x74,                         /* 65k colour, COM split, scan from COM127, C-B-A order */ \
+	SET_DISPLAY_START_LINE, 1, 0x00, \
+	SET_DISPLAY_OFFSET, 1, 0x00, \
+	SSD1351_SET_GPIO, 1, 0x00, \
+	SSD1351_FUNCTION_SELECT, 1, 0x01,           /* internal VDD regulator */ \
+	PHASE_PERIOD_ADJUSTMENT, 1, 0x32, \
+	SET_V_VOLTAGE, 1, 0x05, \
+	SSD1351_NORMAL_DISPLAY, 0, \
+	SSD1351_SET_CONTRAST_ABC, 3, 0xC8, 0x80, 0xC8, \
+	SSD1351_MASTER_CONTRAST, 1, 0x0F, \
+	SSD1351_SET_VSL, 3, 0xA0, 0xB5, 0x55, \
+	SSD1351_SET_SECOND_PRECHARGE, 1, 0x01, \
+	NORMAL_BRIGHTNESS_DISPLAY_ON, 0
+#define PANEL_DIM    SSD1351_MASTER_CONTRAST, 1, 0x04   /* no dim mode, lower the master current instead */
+#define PANEL_BRIGHT SSD1351_MASTER_CONTRAST, 1, 0x0F
+
+#else
+
+#define PANEL_NAME "SSD1331"
+#define OLED_WIDTH 96
+#define OLED_HEIGHT 64
+#define PANEL_BYTES_PER_PIXEL 2
+#define PANEL_SPI_HZ 2000000
+#define PANEL_ARGS_AS_DATA 0
+#define PANEL_WRITE_RAM 0
+#define PANEL_HAS_DRAW_COMMANDS 1
+#define PANEL_REMAP_256 0x32
+#define PANEL_INIT \
+	DISPLAY_OFF, 0, \
+	SET_CONTRAST_A, 1, 0xFF, \
+	SET_CONTRAST_B, 1, 0xFF, \
+	SET_CONTRAST_C, 1, 0xFF, \
+	MASTER_CURRENT_CONTROL, 1, 0x06, \
+	SET_PRECHARGE_SPEED_A, 1, 0x64, \
+	SET_PRECHARGE_SPEED_B, 1, 0x78, \
+	SET_PRECHARGE_SPEED_C, 1, 0x64, \
+	SET_REMAP, 1, 0x72,                         /* 65k colour, COM split, scan from COM63, column remap */ \
+	SET_DISPLAY_START_LINE, 1, 0x00, \
+	SET_DISPLAY_OFFSET, 1, 0x00, \
+	NORMAL_DISPLAY, 0, \
+	SET_MULTIPLEX_RATIO, 1, OLED_HEIGHT - 1, \
+	SET_MASTER_CONFIGURE, 1, 0x8E, \
+	POWER_SAVE_MODE, 1, 0x00, \
+	PHASE_PERIOD_ADJUSTMENT, 1, 0x31, \
+	DISPLAY_CLOCK_DIV, 1, 0xF0, \
+	SET_PRECHARGE_VOLTAGE, 1, 0x3A, \
+	SET_V_VOLTAGE, 1, 0x3E, \
+	DEACTIVE_SCROLLING, 0, \
+	NORMAL_BRIGHTNESS_DISPLAY_ON, 0
+#define PANEL_DIM \
+	DIM_MODE_SETTING, 5, 0x00, 0x40, 0x40, 0x40, 0x1F, /* reserved, contrast A, B, C, pre-charge */ \
+	DIM_MODE_DISPLAY_ON, 0
+#define PANEL_BRIGHT NORMAL_BRIGHTNESS_DISPLAY_ON, 0
+
+#endif
+
+#define PANEL_FRAME_BYTES (OLED_WIDTH * OLED_HEIGHT * PANEL_BYTES_PER_PIXEL)
+#endif
@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "psffont.h"
+
+#define PSF2_MAGIC 0x864ab572
+#define PSF2_HEADER_LEN 32
+#define PSF2_HAS_UNICODE_TABLE 0x01
+#define PSF2_SEPARATOR 0xFF        // ends the code points of one glyph in the unicode table
+#define PSF2_START_SEQUENCE 0xFE   // starts a combining sequence, which is not looked up
+
+static uint32_t read_le32(const unsigned char *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/**
+ * Decode the code point at the start of a UTF-8 text. Malformed, overlong and truncated sequences
+ * decode to PSF_REPLACEMENT and consume only the bytes up to the first one that does not fit,
+ * so decoding picks up again at the next character.
+ *
+ * @returns number of bytes consumed, at least 1 if len > 0.
+ */
+size_t utf8_decode(const char *text, size_t len, uint32_t *codepoint)
+{
+	static const uint32_t min[] = { 0, 0, 0x80, 0x800, 0x10000 };
+	const unsigned char *s = (const unsigned char *) text;
+
+	*codepoint = PSF_REPLACEMENT;
+	if (len == 0) return 0;
+	if (s[0] < 0x80) {
+		*codepoint = s[0];
+		return 1;
+	}
+
+	size_t n = s[0] < 0xC2 ? 0 : s[0] < 0xE0 ? 2 : s[0] < 0xF0 ? 3 : s[0] < 0xF5 ? 4 : 0;
+	if (n == 0) return 1;
+
+	uint32_t cp = s[0] & (0x7F >> n);
+	for (size_t i = 1; i < n; i++) {
+		if (i >= len || (s[i] & 0xC0) != 0x80) return i;
+		cp = cp << 6 | (s[i] & 0x3F);
+	}
+	if (cp >= min[n] && cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF)) *codepoint = cp;
+	return n;
+}
+
+/**
+ * Check the PSF2 header against the size of the mapping and locate the glyphs and the unicode table.
+ *
+ * @returns 1 on success, -1 if the file is not a usable PSF2 font.
+ */
+static int parse_header(PSF_FONT *font)
+{
+	const unsigned char *header = font->map;
+	if (font->size < PSF2_HEADER_LEN || read_le32(header) != PSF2_MAGIC) return -1;
+
+	uint32_t header_len = read_le32(header + 8);
+	uint32_t flags = read_le32(header + 12);
+	font->glyph_cnt = read_le32(header + 16);
+	font->glyph_size = read_le32(header + 20);
+	font->height = read_le32(header + 24);
+	font->width = read_le32(header + 28);
+
+	if (font->width == 0 || font->width > PSF_MAX_WIDTH || font->height == 0 || font->height > PSF_MAX_HEIGHT) return -1;
+	if (font->glyph_size < font->height * ((font->width + 7) / 8)) return -1;
+	if (header_len < PSF2_HEADER_LEN || header_len > font->size || font->glyph_cnt == 0) return -1;
+	if ((font->size - header_len) / font->glyph_size < font->glyph_cnt) return -1;
+
+	font->glyphs = font->map + header_len;
+	size_t table = header_len + (size_t) font->glyph_cnt * font->glyph_size;
+	if (flags & PSF2_HAS_UNICODE_TABLE) {
+		font->unicode = font->map + table;
+		font->unicode_len = font->size - table;
+	}
+	return 1;
+}
+
+/**
+ * Map a PSF2 font file. Only the header is read here; glyphs are rasterized when they are first drawn.
+ *
+ * @returns font or NULL if the file cannot be mapped or is not a usable PSF2 font.
+ */
+PSF_FONT *psf_open(const char *path)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return NULL;
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return NULL;
+
+	PSF_FONT *font = calloc(1, sizeof(PSF_FONT));
+	if (!font) {
+		munmap(map, st.st_size);
+		return NULL;
+	}
+	font->map = map;
+	font->size = st.st_size;
+	if (parse_header(font) < 0) {
+		psf_close(font);
+		return NULL;
+	}
+	return font;
+}
+
+void psf_close(PSF_FONT *font)
+{
+	if (!font) return;
+	munmap((void *) font->map, font->size);
+	free(font);
+}
+
+/**
+ * Find the glyph of a code point by walking the unicode table. This only runs on cache misses,
+ * so no lookup structure is built up front.
+ *
+ * @returns glyph index or -1 if the font has no glyph for the code point.
+ */
+static long find_glyph(const PSF_FONT *font, uint32_t codepoint)
+{
+	if (!font->unicode) return codepoint < font->glyph_cnt ? (long) codepoint : -1;
+
+	const unsigned char *p = font->unicode, *end = font->unicode + font->unicode_len;
+	uint32_t glyph = 0;
+	int in_sequence = 0;
+	while (p < end && glyph < font->glyph_cnt) {
+		if (*p == PSF2_SEPARATOR) {
+			glyph++;
+			in_sequence = 0;
+			p++;
+		} else if (*p == PSF2_START_SEQUENCE) {
+			in_sequence = 1;
+			p++;
+		} else {
+			uint32_t cp;
+			p += utf8_decode((const char *) p, end - p, &cp);
+			if (!in_sequence && cp == codepoint) return glyph;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Turn the bitmap of a glyph into runs of set pixels, row by row.
+ */
+static void rasterize(const PSF_FONT *font, uint32_t glyph, PSF_GLYPH *slot)
+{
+	const unsigned char *bitmap = font->glyphs + (size_t) glyph * font->glyph_size;
+	uint32_t row_bytes = (font->width + 7) / 8;
+
+	slot->span_cnt = 0;
+	for (uint32_t row = 0; row < font->height; row++, bitmap += row_bytes) {
+		int start = -1;
+		for (uint32_t x = 0; x <= font->width; x++) {
+			int set = x < font->width && (bitmap[x / 8] & (0x80 >> (x % 8)));
+			if (set && start < 0) {
+				start = x;
+			} else if (!set && start >= 0) {
+				if (slot->span_cnt == PSF_MAX_SPANS) return;
+				slot->spans[slot->span_cnt++] = (PSF_SPAN) { row, start, x - start };
+				start = -1;
+			}
+		}
+	}
+}
+
+/**
+ * Look up the spans of a code point, rasterizing it into the least recently used slot on a miss.
+ * Code points the font lacks are drawn as U+FFFD, or '?' if the font has no replacement character.
+ */
+static const PSF_GLYPH *get_glyph(PSF_FONT *font, uint32_t codepoint)
+{
+	if (++font->clock == 0) {
+		/* The clock wrapped: keep the cached glyphs but forget their order */
+		for (int i = 0; i < PSF_CACHE_SLOTS; i++)
+			if (font->cache[i].used) font->cache[i].used = 1;
+		font->clock = 2;
+	}
+
+	PSF_GLYPH *victim = &font->cache[0];
+	for (int i = 0; i < PSF_CACHE_SLOTS; i++) {
+		PSF_GLYPH *slot = &font->cache[i];
+		if (slot->used && slot->codepoint == codepoint) {
+			slot->used = font->clock;
+			font->hits++;
+			return slot;
+		}
+		if (slot->used < victim->used) victim = slot;
+	}
+
+	font->misses++;
+	long glyph = find_glyph(font, codepoint);
+	if (glyph < 0) glyph = find_glyph(font, PSF_REPLACEMENT);
+	if (glyph < 0) glyph = find_glyph(font, '?');
+	if (glyph < 0) glyph = 0;
+	rasterize(font, glyph, victim);
+	victim->codepoint = codepoint;
+	victim->used = font->clock;
+	return victim;
+}
+
+/**
+ * @returns width in pixels of a UTF-8 text.
+ */
+int psf_text_width(const PSF_FONT *font, const char *text, size_t len)
+{
+	int chars = 0;
+	uint32_t codepoint;
+	for (size_t n = 0; n < len; chars++)
+		n += utf8_decode(text + n, len - n, &codepoint);
+	return chars * font->width;
+}
+
+/**
+ * Draw a UTF-8 text into an off-screen strip of `font->height` rows in framebuffer byte order,
+ * starting at column x. Drawing stops at the first character that does not fit.
+ *
+ * @returns the column after the drawn text.
+ */
+int psf_text_strip(PSF_FONT *font, unsigned char *strip, int strip_width, int x, const char *text, size_t len, unsigned short rgb)
+{
+	size_t n = 0;
+	while (n < len && x + (int) font->width <= strip_width) {
+		uint32_t codepoint;
+		n += utf8_decode(text + n, len - n, &codepoint);
+		const PSF_GLYPH *glyph = get_glyph(font, codepoint);
+
+		for (uint32_t row = 0; row < font->height; row++)
+			memset(&strip[(row * strip_width + x) * 2], 0, font->width * 2);
+		for (int i = 0; i < glyph->span_cnt; i++) {
+			const PSF_SPAN *span = &glyph->spans[i];
+			unsigned char *pixel = &strip[(span->row * strip_width + x + span->x) * 2];
+			for (int j = 0; j < span->len; j++, pixel += 2) {
+				pixel[0] = rgb >> 8;
+				pixel[1] = rgb;
+			}
+		}
+		x += font->width;
+	}
+	return x;
+}
@@ -0,0 +1,56 @@
+#ifndef _PSFFONT_H_
+#define _PSFFONT_H_
+#include <stddef.h>
+#include <stdint.h>
+
+#define PSF_MAX_WIDTH 16          // wider fonts are rejected
+#define PSF_MAX_HEIGHT 32         // taller fonts are rejected
+#define PSF_MAX_SPANS 96          // spans kept per glyph, the rest of an unusually busy glyph is dropped
+#define PSF_CACHE_SLOTS 64        // rasterized glyphs kept at a time
+#define PSF_REPLACEMENT 0xFFFD    // code point shown for malformed UTF-8
+
+/**
+ * Horizontal run of set pixels in a glyph.
+ */
+typedef struct PSF_SPAN {
+	uint8_t row;
+	uint8_t x;
+	uint8_t len;
+} PSF_SPAN;
+
+/**
+ * Cache slot holding one glyph as spans, ready to be copied to a strip.
+ */
+typedef struct PSF_GLYPH {
+	uint32_t codepoint;
+	uint32_t used;               // cache clock at the last lookup, 0 if the slot is empty
+	uint16_t span_cnt;
+	PSF_SPAN spans[PSF_MAX_SPANS];
+} PSF_GLYPH;
+
+/**
+ * PSF2 font mapped read-only into memory. Glyph bitmaps are only read when a code point is drawn
+ * for the first time or after it was evicted from the cache.
+ */
+typedef struct PSF_FONT {
+	const unsigned char *map;
+	size_t size;
+	const unsigned char *glyphs;   // first glyph bitmap
+	const unsigned char *unicode;  // unicode table, NULL if glyphs are indexed by code point
+	size_t unicode_len;
+	uint32_t glyph_cnt;
+	uint32_t glyph_size;           // bytes per glyph bitmap
+	uint32_t width;
+	uint32_t height;
+	uint32_t clock;
+	long hits;
+	long misses;
+	PSF_GLYPH cache[PSF_CACHE_SLOTS];
+} PSF_FONT;
+
+size_t utf8_decode(const char *, size_t, uint32_t *);
+PSF_FONT *psf_open(const char *);
+void psf_close(PSF_FONT *);
+int psf_text_width(const PSF_FONT *, const char *, size_t);
+int psf_text_strip(PSF_FONT *, unsigned char *, int, int, const char *, size_t, unsigned short);
+#endif
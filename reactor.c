@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <librdkafka/rdkafka.h>
+#include "reactor.h"
+
+#define REACTOR_MAX_EVENTS 3
+
+static int watch_fd(REACTOR *reactor, int fd) {
+	struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+	return epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0 ? 1 : -1;
+}
+
+/**
+ * Change the frame tick to every tick_ms, starting tick_ms from now.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int reactor_set_tick(REACTOR *reactor, long tick_ms) {
+	struct itimerspec tick = {
+		.it_interval = { .tv_sec = tick_ms / 1000, .tv_nsec = (tick_ms % 1000) * 1000000L },
+		.it_value    = { .tv_sec = tick_ms / 1000, .tv_nsec = (tick_ms % 1000) * 1000000L },
+	};
+	return timerfd_settime(reactor->timer_fd, 0, &tick, NULL) == 0 ? 1 : -1;
+}
+
+/**
+ * Set up the epoll instance with a frame tick every tick_ms and termination signals.
+ * SIGINT and SIGTERM are blocked for the calling thread and every thread created afterwards
+ * (librdkafka's included), so call this before init_kafka_handler().
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int reactor_init(REACTOR *reactor, long tick_ms) {
+	sigset_t signals;
+
+	reactor->kafka_fd = -1;
+	reactor->queue = NULL;
+
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+	reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	reactor->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	reactor->signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (reactor->epoll_fd < 0 || reactor->timer_fd < 0 || reactor->signal_fd < 0) {
+		perror("Failed to create event loop");
+		return -1;
+	}
+
+	if (reactor_set_tick(reactor, tick_ms) < 0 ||
+	    watch_fd(reactor, reactor->timer_fd) < 0 ||
+	    watch_fd(reactor, reactor->signal_fd) < 0) {
+		perror("Failed to set up event loop");
+		return -1;
+	}
+
+	return 1;
+}
+
+/**
+ * Have librdkafka signal an eventfd whenever the consumer queue goes from empty to non-empty.
+ * The queue is only signalled on that transition, so it has to be drained completely after every wakeup.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int reactor_watch_kafka(REACTOR *reactor, rd_kafka_t *rk) {
+	static const uint64_t wakeup = 1; // eventfd counters are written in units of 8 bytes
+
+	reactor->kafka_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (reactor->kafka_fd < 0 || watch_fd(reactor, reactor->kafka_fd) < 0) {
+		perror("Failed to watch consumer queue");
+		return -1;
+	}
+
+	reactor->queue = rd_kafka_queue_get_consumer(rk);
+	if (!reactor->queue) {
+		fprintf(stderr, "%% Failed to get consumer queue\n");
+		return -1;
+	}
+	rd_kafka_queue_io_event_enable(reactor->queue, reactor->kafka_fd, &wakeup, sizeof(wakeup));
+
+	return 1;
+}
+
+/**
+ * Sleep until at least one event happened.
+ *
+ * @returns the REACTOR_* bits of all events that happened, 0 if interrupted.
+ */
+int reactor_wait(REACTOR *reactor) {
+	struct epoll_event ready[REACTOR_MAX_EVENTS];
+	int events = 0;
+
+	int cnt = epoll_wait(reactor->epoll_fd, ready, REACTOR_MAX_EVENTS, -1);
+	if (cnt < 0) return errno == EINTR ? 0 : REACTOR_STOP;
+
+	for (int i = 0; i < cnt; i++) {
+		int fd = ready[i].data.fd;
+		if (fd == reactor->kafka_fd) {
+			uint64_t count;
+			if (read(fd, &count, sizeof(count)) > 0) events |= REACTOR_MESSAGES;
+		}
+		else if (fd == reactor->timer_fd) {
+			uint64_t expirations;
+			if (read(fd, &expirations, sizeof(expirations)) > 0) events |= REACTOR_TICK;
+		}
+		else if (fd == reactor->signal_fd) {
+			struct signalfd_siginfo info;
+			if (read(fd, &info, sizeof(info)) > 0) events |= REACTOR_STOP;
+		}
+	}
+
+	return events;
+}
+
+/**
+ * Stop watching the consumer queue and close the event loop. Call before the consumer is destroyed.
+ */
+void reactor_close(REACTOR *reactor) {
+	if (reactor->queue) {
+		rd_kafka_queue_io_event_enable(reactor->queue, -1, NULL, 0);
+		rd_kafka_queue_destroy(reactor->queue);
+		reactor->queue = NULL;
+	}
+	if (reactor->kafka_fd >= 0) close(reactor->kafka_fd);
+	if (reactor->timer_fd >= 0) close(reactor->timer_fd);
+	if (reactor->signal_fd >= 0) close(reactor->signal_fd);
+	if (reactor->epoll_fd >= 0) close(reactor->epoll_fd);
+}
@@ -0,0 +1,27 @@
+#ifndef _REACTOR_H_
+#define _REACTOR_H_
+#include <librdkafka/rdkafka.h>
+
+/* Bits returned by reactor_wait() */
+#define REACTOR_MESSAGES 0x1  // the consumer queue became non-empty
+#define REACTOR_TICK     0x2  // a frame tick elapsed
+#define REACTOR_STOP     0x4  // SIGINT or SIGTERM was received
+
+/**
+ * Single-threaded event loop: librdkafka queue I/O events, frame ticks and termination
+ * signals are multiplexed on one epoll instance, so the process sleeps until one of them happens.
+ */
+typedef struct REACTOR {
+	int epoll_fd;
+	int kafka_fd;   // eventfd written by librdkafka when the consumer queue becomes non-empty
+	int timer_fd;   // timerfd firing every frame tick
+	int signal_fd;  // signalfd receiving SIGINT and SIGTERM
+	rd_kafka_queue_t *queue;
+} REACTOR;
+
+int reactor_init(REACTOR *, long);
+int reactor_set_tick(REACTOR *, long);
+int reactor_watch_kafka(REACTOR *, rd_kafka_t *);
+int reactor_wait(REACTOR *);
+void reactor_close(REACTOR *);
+#endif
@@ -0,0 +1,115 @@
+#include <string.h>
+#include "record.h"
+
+static uint64_t read_le64(const unsigned char *p)
+{
+	uint64_t value = 0;
+	for (int i = 7; i >= 0; i--) value = (value << 8) | p[i];
+	return value;
+}
+
+static uint32_t read_le32(const unsigned char *p)
+{
+	return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static void write_le64(unsigned char *p, uint64_t value)
+{
+	for (int i = 0; i < 8; i++, value >>= 8) p[i] = value & 0xFF;
+}
+
+static void write_le32(unsigned char *p, uint32_t value)
+{
+	for (int i = 0; i < 4; i++, value >>= 8) p[i] = value & 0xFF;
+}
+
+/**
+ * @returns 1 if the payload starts like a binary record, 0 if it has to be treated as text.
+ */
+int record_is_binary(const void *buf, size_t len)
+{
+	return len >= RECORD_HEADER_LEN && ((const unsigned char *) buf)[0] == RECORD_MAGIC;
+}
+
+/**
+ * Decode a binary record. Values beyond RECORD_MAX_VALUES are skipped.
+ *
+ * @returns 1 on success, -1 if the payload is not a valid record of a supported version.
+ */
+int record_decode(const void *buf, size_t len, RECORD *record)
+{
+	const unsigned char *p = buf;
+
+	if (!record_is_binary(buf, len) || p[1] != RECORD_VERSION) return -1;
+
+	int value_cnt = p[2];
+	size_t device_len = p[3];
+	if (len < RECORD_HEADER_LEN + device_len + (size_t) value_cnt * RECORD_VALUE_LEN) return -1;
+
+	record->version = p[1];
+	record->timestamp_ms = (int64_t) read_le64(p + 4);
+	record->device = (const char *) p + RECORD_HEADER_LEN;
+	record->device_len = device_len;
+	record->value_cnt = value_cnt < RECORD_MAX_VALUES ? value_cnt : RECORD_MAX_VALUES;
+
+	p += RECORD_HEADER_LEN + device_len;
+	for (int i = 0; i < record->value_cnt; i++, p += RECORD_VALUE_LEN) {
+		uint32_t raw = read_le32(p + 1);
+		record->values[i].type = p[0];
+		memcpy(&record->values[i].i32, &raw, sizeof raw);
+	}
+
+	return 1;
+}
+
+/**
+ * Encode a record into buf.
+ *
+ * @returns the length of the record, or 0 if it does not fit into size bytes.
+ */
+size_t record_encode(void *buf, size_t size, const char *device, int64_t timestamp_ms, const RECORD_VALUE *values, int value_cnt)
+{
+	unsigned char *p = buf;
+	size_t device_len = strlen(device);
+
+	if (device_len > RECORD_MAX_DEVICE_LEN) device_len = RECORD_MAX_DEVICE_LEN;
+	if (value_cnt > RECORD_MAX_VALUES) value_cnt = RECORD_MAX_VALUES;
+
+	size_t len = RECORD_HEADER_LEN + device_len + (size_t) value_cnt * RECORD_VALUE_LEN;
+	if (len > size) return 0;
+
+	p[0] = RECORD_MAGIC;
+	p[1] = RECORD_VERSION;
+	p[2] = value_cnt;
+	p[3] = device_len;
+	write_le64(p + 4, (uint64_t) timestamp_ms);
+	memcpy(p + RECORD_HEADER_LEN, device, device_len);
+
+	p += RECORD_HEADER_LEN + device_len;
+	for (int i = 0; i < value_cnt; i++, p += RECORD_VALUE_LEN) {
+		uint32_t raw;
+		memcpy(&raw, &values[i].i32, sizeof raw);
+		p[0] = values[i].type;
+		write_le32(p + 1, raw);
+	}
+
+	return len;
+}
+
+/**
+ * Convert a value of any type to float. Unknown types read as 0.
+ * The 4 value bytes are decoded as every type at once and the type only indexes the results,
+ * so there is no branch on the type. Converting float bits as an integer or the other way round is harmless.
+ */
+float record_value_float(const RECORD_VALUE *value)
+{
+	float f32;
+	memcpy(&f32, &value->i32, sizeof f32);
+
+	const float decoded[RECORD_TYPES] = {
+		[RECORD_F32] = f32,
+		[RECORD_I32] = (float) value->i32,
+		[RECORD_MILLI] = value->i32 * 0.001f,
+	};
+	return decoded[value->type < RECORD_TYPES ? value->type : 0];
+}
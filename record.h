@@ -0,0 +1,55 @@
+#ifndef _RECORD_H_
+#define _RECORD_H_
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Binary telemetry record, all integers little-endian:
+ *
+ *   0  magic       0xB7 (never the first byte of a text payload)
+ *   1  version     RECORD_VERSION
+ *   2  value_cnt   amount of values following the device id
+ *   3  device_len  length of the device id
+ *   4  timestamp   event time in ms since the epoch (8 bytes)
+ *  12  device id   device_len bytes, not terminated
+ *   .  values      value_cnt times: type (1 byte) + value (4 bytes)
+ */
+#define RECORD_MAGIC 0xB7
+#define RECORD_VERSION 1
+#define RECORD_HEADER_LEN 12
+#define RECORD_VALUE_LEN 5
+#define RECORD_MAX_VALUES 8
+#define RECORD_MAX_DEVICE_LEN 32
+
+typedef enum RECORD_TYPE {
+	RECORD_F32 = 1,   // IEEE 754 single precision
+	RECORD_I32 = 2,   // signed integer
+	RECORD_MILLI = 3, // signed fixed-point integer in thousandths
+	RECORD_TYPES      // types below this one are known, 0 is none
+} RECORD_TYPE;
+
+typedef struct RECORD_VALUE {
+	uint8_t type;
+	union {
+		float f32;
+		int32_t i32;
+	};
+} RECORD_VALUE;
+
+/**
+ * Decoded record. The device id points into the decoded buffer.
+ */
+typedef struct RECORD {
+	uint8_t version;
+	int64_t timestamp_ms;
+	const char *device;
+	size_t device_len;
+	int value_cnt;
+	RECORD_VALUE values[RECORD_MAX_VALUES];
+} RECORD;
+
+int record_is_binary(const void *, size_t);
+int record_decode(const void *, size_t, RECORD *);
+size_t record_encode(void *, size_t, const char *, int64_t, const RECORD_VALUE *, int);
+float record_value_float(const RECORD_VALUE *);
+#endif
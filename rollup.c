@@ -0,0 +1,94 @@
+#include <string.h>
+#include "rollup.h"
+
+static const long tier_width_ms[ROLLUP_TIERS] = { 10000, 60000, 3600000 };
+
+void rollup_init(ROLLUP *rollup)
+{
+	memset(rollup, 0, sizeof *rollup);
+	for (int tier = 0; tier < ROLLUP_TIERS; tier++) {
+		rollup->tiers[tier].width_ms = tier_width_ms[tier];
+	}
+}
+
+static void merge_point(ROLLUP_POINT *into, const ROLLUP_POINT *point)
+{
+	if (!point->count) return;
+	if (!into->count || point->min < into->min) into->min = point->min;
+	if (!into->count || point->max > into->max) into->max = point->max;
+	into->sum += point->sum;
+	into->count += point->count;
+}
+
+static void push_point(ROLLUP_TIER *tier, const ROLLUP_POINT *point)
+{
+	tier->points[tier->head] = *point;
+	tier->head = (tier->head + 1) % ROLLUP_CAPACITY;
+	if (tier->count < ROLLUP_CAPACITY) tier->count++;
+}
+
+/**
+ * Fold the aggregate of the interval starting at `start_ms` into the given tier.
+ * When it belongs to a later interval than the open one, the open interval is closed and handed to the next tier,
+ * and skipped intervals are stored as gaps. An aggregate older than the open interval is counted into the open one.
+ */
+static void fold(ROLLUP *rollup, int tier_idx, int64_t start_ms, const ROLLUP_POINT *point)
+{
+	ROLLUP_TIER *tier = &rollup->tiers[tier_idx];
+	int64_t interval_ms = start_ms - start_ms % tier->width_ms;
+
+	if (tier->has_open && interval_ms > tier->open_start_ms) {
+		static const ROLLUP_POINT gap = { 0 };
+
+		push_point(tier, &tier->open);
+		if (tier_idx + 1 < ROLLUP_TIERS) fold(rollup, tier_idx + 1, tier->open_start_ms, &tier->open);
+
+		/* Gaps longer than the ring buffer only need to clear it */
+		int64_t skipped = (interval_ms - tier->open_start_ms) / tier->width_ms - 1;
+		if (skipped > ROLLUP_CAPACITY) skipped = ROLLUP_CAPACITY;
+		for (int64_t i = 0; i < skipped; i++) push_point(tier, &gap);
+		tier->has_open = 0;
+	}
+	if (!tier->has_open) {
+		memset(&tier->open, 0, sizeof tier->open);
+		tier->open_start_ms = interval_ms;
+		tier->has_open = 1;
+	}
+	merge_point(&tier->open, point);
+}
+
+/**
+ * Add a closed chart bucket. Buckets have to arrive in event time order, as ts_pop() hands them out.
+ */
+void rollup_add(ROLLUP *rollup, const TS_BUCKET *bucket)
+{
+	ROLLUP_POINT point = { bucket->min, bucket->max, bucket->sum, bucket->count };
+	fold(rollup, 0, bucket->start_ms, &point);
+}
+
+/**
+ * Fetch a point of a tier. Index 0 is the open interval, so a coarse tier shows recent samples
+ * before its interval ends; higher indexes go back in time.
+ *
+ * @returns 1 if the point was stored in `point`, 0 if the tier does not reach back that far.
+ */
+int rollup_point(const ROLLUP *rollup, int tier_idx, int index, ROLLUP_POINT *point)
+{
+	const ROLLUP_TIER *tier = &rollup->tiers[tier_idx];
+
+	if (!tier->has_open || index < 0 || index > tier->count) return 0;
+	if (index == 0) {
+		*point = tier->open;
+		return 1;
+	}
+
+	int slot = tier->head - index;
+	if (slot < 0) slot += ROLLUP_CAPACITY;
+	*point = tier->points[slot];
+	return 1;
+}
+
+float rollup_point_mean(const ROLLUP_POINT *point)
+{
+	return point->count ? point->sum / point->count : 0.0f;
+}
@@ -0,0 +1,44 @@
+#ifndef _ROLLUP_H_
+#define _ROLLUP_H_
+#include <stdint.h>
+#include "timeseries.h"
+
+#define ROLLUP_TIERS 3
+#define ROLLUP_CAPACITY 168 // closed points kept per tier: 28 min of 10 s, 2.8 h of 1 min, 7 days of 1 h
+
+/**
+ * Aggregate of the samples in one rollup interval. A point without samples (count == 0) is a gap.
+ */
+typedef struct ROLLUP_POINT {
+	float min, max, sum;
+	uint32_t count;
+} ROLLUP_POINT;
+
+/**
+ * Fixed-width intervals of one resolution: the open interval and a ring buffer of closed ones.
+ */
+typedef struct ROLLUP_TIER {
+	long width_ms;
+	int has_open;
+	int64_t open_start_ms;
+	ROLLUP_POINT open;
+	ROLLUP_POINT points[ROLLUP_CAPACITY];
+	int head;  // index the next closed point is written to
+	int count;
+} ROLLUP_TIER;
+
+/**
+ * Cascading rollups of one value stream at 10 s, 1 min and 1 h.
+ * Each closed interval is folded into the next coarser tier, so a sample is only aggregated once per tier
+ * and every tier can be drawn without looking at finer data.
+ * The size is fixed at about 2.7 KB per tier, 8.1 KB per stream.
+ */
+typedef struct ROLLUP {
+	ROLLUP_TIER tiers[ROLLUP_TIERS];
+} ROLLUP;
+
+void rollup_init(ROLLUP *);
+void rollup_add(ROLLUP *, const TS_BUCKET *);
+int rollup_point(const ROLLUP *, int, int, ROLLUP_POINT *);
+float rollup_point_mean(const ROLLUP_POINT *);
+#endif
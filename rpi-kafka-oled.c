@@ -8,10 +8,22 @@
 #include <signal.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
 #include <librdkafka/rdkafka.h>
 #include "kafkautils.h"
 #include "ssd1331.h"
 #include "timeops.h"
+#include "metrics.h"
+#include "msgref.h"
+#include "handoff.h"
+#include "latency.h"
+#include "kafkastats.h"
+#include "reactor.h"
+#include "idle.h"
+#include "history.h"
+#include "psffont.h"
+#include "marquee.h"
+#include "logview.h"
 #include "gui.h"
 
 #define SHOW_TOP_DEBUG 0
@@ -19,7 +31,7 @@
 #define BOTTOM_DEBUG_RGB (RGB(60,60,200))
 #define MS_PER_UPDATE_GRAPHICS 16
 #define MS_PER_UPDATE_LOGIC 1000 
-#define AMOUNT_PARTICLES 48
+#define CHART_COLUMNS 48
 #define AMOUNT_STARS 48
 #define TYPE_1_STAR 1
 #define TYPE_2_STAR 2
@@ -31,6 +43,8 @@
 #define TYPE_3_STAR_CHANCE 500
 #define TEMP_SCALE_MAX 30 
 #define TEMP_SCALE_MIN -10
+#define HANDOFF_HIGH_WATERMARK 16
+#define STATS_INTERVAL_MS 5000
 
 /** 
  * Global variable determining if main loop should run 
@@ -64,15 +78,24 @@ typedef struct BACKGROUND {
 
 typedef struct INSTANCE {
 	BACKGROUND *background;
-	PARTICLE *particles;
+	HISTORY history;             // chart samples, one per column
 	DEBUG_INFO debug_info;
 	rd_kafka_t *kafka_handler;
 	float temperature;
+	HANDOFF handoff;             // messages handed over by the consumer, waiting to be shown
+	MARQUEE marquee;             // payload of the shown message, rasterized when it arrived
+	LOGVIEW logview;             // latest messages when started with -l, instead of the animated screen
+	LATENCY_TRACE pending_trace; // stage timestamps of the shown message until a frame displayed it
+	int show_freshness;          // draw the p99 produce-to-glass latency
+	char freshness[16];
+	int show_stats;              // draw consumer lag and broker round trip time
+	char stats[24];
 } INSTANCE;
 
 typedef struct KAFKA_CONSUMER_ARGS {
 	rd_kafka_t *rk; // pointer to kafka consumer instance
-	char *payload; // the latest message text from the topic will be stored in this pointer
+	HANDOFF *handoff; // printable messages from the topic will be handed over to the renderer here
+	int accept_utf8;  // a font file can draw them, so UTF-8 text is printable as well
 } KAFKA_CONSUMER_ARGS;
 
 /** 
@@ -121,7 +144,7 @@ static int init_background(BACKGROUND *background)
 /**
  * Initializes the program instance
  */
-int init(INSTANCE *instance) 
+int init(INSTANCE *instance, int columns, PSF_FONT *font) 
 {
 	/* Setup wiring of GPIO */
 	if(wiringPiSetup() < 0) return -1;
@@ -133,26 +156,28 @@ int init(INSTANCE *instance)
 	BACKGROUND *background = malloc(sizeof *background);
 	if (!background || !init_background(background)) return -1;
 	
-	/* Allocate memory for stars in the background*/
-	PARTICLE *particles = malloc(AMOUNT_PARTICLES * sizeof *particles);
-	if (!particles) return -1;	
-	
 	instance->background = background;
-	instance->particles = particles;
 	instance->temperature = 30.0f;
 
-	/* Place temperature particles in their initial position */
-	for (int i = 0; i < AMOUNT_PARTICLES; i++) {
-		PARTICLE *current_particle = &instance->particles[i];
-		current_particle->x = OLED_WIDTH - i*(OLED_WIDTH/AMOUNT_PARTICLES);
-		current_particle->y = float_to_screen_y(instance->temperature);
-		int mod = i * (255 / AMOUNT_PARTICLES);
-		current_particle->rgb = RGB((255-mod),mod,mod);
-		current_particle->type = 0;
+	/* Start the chart as a flat line at the initial temperature */
+	if (history_init(&instance->history, columns) < 0) return -1;
+	for (int i = 0; i < columns; i++) {
+		history_push(&instance->history, instance->temperature, float_to_screen_y(instance->temperature));
 	}
 
 	/* Write initial debug info */
 	sprintf(instance->debug_info.bottom, "[]");
+	instance->marquee.strip = NULL;
+	instance->marquee.font = font;
+	instance->marquee.height = 0;
+	instance->marquee.capacity = 0;
+	if (marquee_set(&instance->marquee, "[", "", 0, "]", BOTTOM_DEBUG_RGB) < 0) return -1;
+	instance->pending_trace.produced_us = 0;
+	instance->pending_trace.consumed_us = 0;
+	instance->show_freshness = 0;
+	instance->freshness[0] = '\0';
+	instance->show_stats = 0;
+	instance->stats[0] = '\0';
 
 	/* Turn on the OLED screen */
 	SSD1331_begin();
@@ -189,18 +214,10 @@ int update_background(INSTANCE *instance, const float lag_ms)
  */
 int update_temperature (INSTANCE *instance, float temperature) 
 {
-	PARTICLE *current_temperature;
-	PARTICLE *previous_temperature;
-
 	instance->temperature = temperature;
 
-	/* Code responsible for adjusting the line chart when time elapses */
-	for (int i = AMOUNT_PARTICLES - 1; i > 0; i--) {
-		current_temperature = &instance->particles[i];
-		previous_temperature = &instance->particles[i-1];
-		current_temperature->y = previous_temperature->y;
-	}
-	instance->particles[0].y = float_to_screen_y(instance->temperature);
+	/* The new sample replaces the oldest one, so the chart scrolls by one column */
+	history_push(&instance->history, temperature, float_to_screen_y(temperature));
 	sprintf(instance->debug_info.bottom, "%.1f'C", instance->temperature);
 	
 	return 1;	
@@ -225,16 +242,20 @@ static int render_background(const INSTANCE *instance)
  */
 static int render_termometer(const INSTANCE *instance) 
 {
-	PARTICLE *current_temperature;
-	PARTICLE *previous_temperature;
-	for (int i = 0; i < AMOUNT_PARTICLES; i++) {
-		current_temperature = &instance->particles[i];
-	    previous_temperature = &instance->particles[i < AMOUNT_PARTICLES - 1 ? i+1 : 0];
-		if (i < AMOUNT_PARTICLES - 1) {
-			SSD1331_line(current_temperature->x, current_temperature->y, 
-						previous_temperature->x, previous_temperature->y, 
-						current_temperature->rgb);
-		}
+	HISTORY_ITER iter;
+	HISTORY_SAMPLE current, previous;
+	int columns = instance->history.capacity;
+	int x = OLED_WIDTH - 1;
+
+	/* Newest sample at the right edge, fading from red to cyan towards the oldest one at the left edge */
+	history_iter_begin(&iter, &instance->history);
+	if (!history_iter_next(&iter, &previous)) return 1;
+	for (int i = 1; history_iter_next(&iter, &current); i++) {
+		int next_x = OLED_WIDTH - 1 - i * (OLED_WIDTH - 1) / (columns - 1);
+		int mod = (i - 1) * 255 / columns;
+		SSD1331_line(x, previous.y, next_x, current.y, RGB((255-mod),mod,mod));
+		previous = current;
+		x = next_x;
 	}
 
 	return 1;
@@ -249,7 +270,48 @@ static int render_debug(const INSTANCE *instance)
 		SSD1331_string(0, TOP_DEBUG_STRING_Y, instance->debug_info.top, 12, 1, RGB(255,255,0));
 	}
 	if (SHOW_BOTTOM_DEBUG) {
-		SSD1331_string(0, BOTTOM_DEBUG_STRING_Y, instance->debug_info.bottom, 12, 1, BOTTOM_DEBUG_RGB);
+		/* The payload was rasterized once when the message arrived, only a window of it is copied.
+		   A taller font file keeps the bottom edge of the line. */
+		marquee_draw(&instance->marquee, BOTTOM_DEBUG_STRING_Y + MARQUEE_SIZE - instance->marquee.height);
+	}
+
+	if (instance->show_stats && instance->stats[0]) {
+		SSD1331_string53(0, STATS_STRING_Y, instance->stats, 2, 1, BOTTOM_DEBUG_RGB);
+	}
+	if (instance->show_freshness && instance->freshness[0]) {
+		int x = OLED_WIDTH - 4 * strlen(instance->freshness);
+		SSD1331_string53(x, FRESHNESS_STRING_Y, instance->freshness, 2, 1, BOTTOM_DEBUG_RGB);
+	}
+
+	return 1;
+}
+
+/**
+ * Show the payload of the given message in the bottom line and release the message.
+ * The payload is rasterized once, straight from the message; frames only copy the strip,
+ * so the message does not have to be kept while it is on screen.
+ */
+static int show_message(INSTANCE *instance, MESSAGE_REF *message)
+{
+	int ret = marquee_set(&instance->marquee, "[", message->payload, message->len, "]", BOTTOM_DEBUG_RGB);
+
+	latency_merge(&instance->pending_trace, &message->trace);
+	msgref_release(message);
+	return ret;
+}
+
+/**
+ * Append every waiting message to the log view. Only the rows of the new lines are sent to the panel.
+ */
+static int show_logged_messages(INSTANCE *instance)
+{
+	MESSAGE_REF *message;
+
+	while ((message = handoff_pop(&instance->handoff))) {
+		long long render_us = get_monotonic_time_us();
+		logview_append(&instance->logview, message->payload, message->len, BOTTOM_DEBUG_RGB);
+		latency_displayed(&message->trace, render_us, get_monotonic_time_us());
+		msgref_release(message);
 	}
 
 	return 1;
@@ -267,6 +329,8 @@ int render(const INSTANCE *instance, const float ms)
 	render_debug(instance);	
 	
 	SSD1331_display();
+	metrics_add(METRIC_FRAMES_RENDERED, 1);
+	metrics_add(METRIC_FRAME_BYTES, SSD1331_frame_bytes());
 	
 	return 1;
 }
@@ -278,13 +342,22 @@ int deallocate_instance_from_memory(INSTANCE *instance)
 {
 	free(instance->background->stars);
 	free(instance->background);
-	free(instance->particles);
 
-	/* Close the consumer: commit final offsets and leave the group. */
-	fprintf(stderr, "%% Closing consumer\n");
-	rd_kafka_consumer_close(instance->kafka_handler);
-	/* Destroy the consumer */
-	rd_kafka_destroy(instance->kafka_handler);
+	/* Stop the decode workers before the partition queues go away, nothing is handed over after that */
+	kafka_stop_workers();
+
+	/* Messages have to be released before the consumer is destroyed */
+	marquee_free(&instance->marquee);
+	handoff_clear(&instance->handoff);
+
+	/* Close the consumer: commit final offsets and leave the group. There is none while replaying. */
+	if (instance->kafka_handler) {
+		fprintf(stderr, "%% Closing consumer\n");
+		rd_kafka_consumer_close(instance->kafka_handler);
+		/* Destroy the consumer */
+		rd_kafka_destroy(instance->kafka_handler);
+	}
+	kafka_close_logs();
 
 	free(instance);
 
@@ -297,73 +370,121 @@ int deallocate_instance_from_memory(INSTANCE *instance)
 static int is_printable (const char *buf, size_t size) {
         size_t i;
         for (i = 0 ; i < size ; i++)
-                if (!isprint((int)buf[i]))
+                if (!isprint((unsigned char)buf[i]))
                         return 0;
         return 1;
 }
 
+/**
+ * @returns 1 if the bytes are well-formed UTF-8 without control characters, else 0.
+ */
+static int is_printable_utf8 (const char *buf, size_t size) {
+        size_t i = 0;
+        while (i < size) {
+                uint32_t cp;
+                i += utf8_decode(buf + i, size - i, &cp);
+                if (cp == PSF_REPLACEMENT || cp < 0x20 || (cp >= 0x7F && cp < 0xA0))
+                        return 0;
+        }
+        return 1;
+}
+
+/**
+ * Handle a single consumed message: print it and, if printable, hand it over as the latest message.
+ * Runs on the consumer thread, or on a decode worker when started with -w.
+ */
+static void handle_message(rd_kafka_t *rk, rd_kafka_message_t *rkm, void *opaque) {
+
+	struct KAFKA_CONSUMER_ARGS *args = (struct KAFKA_CONSUMER_ARGS *) opaque;
+
+	/* Proper message. */
+	printf("Message on %s [%"PRId32"] at offset %"PRId64":\n",
+		   kafka_message_topic(rkm), rkm->partition,
+		   rkm->offset);
+
+	/* Print the message key. */
+	if (rkm->key && is_printable(rkm->key, rkm->key_len))
+			printf(" Key: %.*s\n",
+				   (int)rkm->key_len, (const char *)rkm->key);
+	else if (rkm->key)
+			printf(" Key: (%d bytes)\n", (int)rkm->key_len);
+
+	/* Print the message value/payload. */
+	if (rkm->payload && (args->accept_utf8 ? is_printable_utf8(rkm->payload, rkm->len) : is_printable(rkm->payload, rkm->len))){
+			printf(" Value: %.*s\n",
+				   (int)rkm->len, (const char *)rkm->payload);
+	/* Hand the message itself over to the renderer, it is released once no longer shown */
+			kafka_track_message(rk, rkm);
+			MESSAGE_REF *ref = msgref_new(rkm);
+			if (ref) latency_consumed(&ref->trace, rkm);
+			handoff_push(args->handoff, ref);
+			return;
+	}
+	else if (rkm->key)
+			printf(" Value: (%d bytes)\n", (int)rkm->len);
+
+	kafka_track_message(rk, rkm);
+	kafka_message_destroy(rkm);
+}
+
+/**
+ * Hand a polled message over to handle_message(), consumer errors are only reported.
+ */
+static void dispatch_message(struct KAFKA_CONSUMER_ARGS *args, rd_kafka_message_t *rkm) {
+
+	/* consumer_poll() will return either a proper message
+	 * or a consumer error (rkm->err is set). */
+	if (rkm->err) {
+			/* Consumer errors are generally to be considered
+			 * informational as the consumer will automatically
+			 * try to recover from all types of errors. */
+			fprintf(stderr,
+					"%% Consumer error: %s\n",
+					rd_kafka_message_errstr(rkm));
+			kafka_message_destroy(rkm);
+			return;
+	}
+
+	handle_message(args->rk, rkm, args);
+}
+
+/**
+ * Consume every message waiting in the consumer queue without blocking (event loop mode).
+ */
+static void consume_available_messages(struct KAFKA_CONSUMER_ARGS *args) {
+	rd_kafka_message_t *rkm;
+
+	while ((rkm = kafka_consumer_poll(args->rk, 0)) != NULL)
+		dispatch_message(args, rkm);
+}
+
 /** 
  * Run kafka message consumer in a separate thread.
  *
  * @param args - pointer to a KAFKA_CONSUMER_ARGS struct.
  *
  * The handler *rk inside args needs to be already initialized and subscribed to a topic.
- * The text of the latest received message will be stored under the args->payload pointer.
+ * Printable messages will be handed over to the renderer through args->handoff.
+ * With decode workers this thread only serves rebalances and consumer errors.
  */
 void *consume_kafka_messages(void *vargp) {
 
 	struct KAFKA_CONSUMER_ARGS *args = (struct KAFKA_CONSUMER_ARGS *) vargp;
 	rd_kafka_t *rk = args->rk;
-	char *payload = args->payload;
 	
 	signal(SIGINT, stop);
 	
 	while (program_is_running) {
 		rd_kafka_message_t *rkm;
 
-		rkm = rd_kafka_consumer_poll(rk, 100);
+		rkm = kafka_consumer_poll(rk, 100);
 		if (!rkm)
 				continue; /* Timeout: no message within 100ms,
 						   *  try again. This short timeout allows
 						   *  checking for `run` at frequent intervals.
 						   */
 
-		/* consumer_poll() will return either a proper message
-		 * or a consumer error (rkm->err is set). */
-		if (rkm->err) {
-				/* Consumer errors are generally to be considered
-				 * informational as the consumer will automatically
-				 * try to recover from all types of errors. */
-				fprintf(stderr,
-						"%% Consumer error: %s\n",
-						rd_kafka_message_errstr(rkm));
-				rd_kafka_message_destroy(rkm);
-				continue;
-		}
-
-		/* Proper message. */
-		printf("Message on %s [%"PRId32"] at offset %"PRId64":\n",
-			   rd_kafka_topic_name(rkm->rkt), rkm->partition,
-			   rkm->offset);
-
-		/* Print the message key. */
-		if (rkm->key && is_printable(rkm->key, rkm->key_len))
-				printf(" Key: %.*s\n",
-					   (int)rkm->key_len, (const char *)rkm->key);
-		else if (rkm->key)
-				printf(" Key: (%d bytes)\n", (int)rkm->key_len);
-
-		/* Print the message value/payload. */
-		if (rkm->payload && is_printable(rkm->payload, rkm->len)){
-				printf(" Value: %.*s\n",
-					   (int)rkm->len, (const char *)rkm->payload);
-		/* Copy message text into the payload pointer */
-				sprintf(payload, (const char *)rkm->payload);
-		}
-		else if (rkm->key)
-				printf(" Value: (%d bytes)\n", (int)rkm->len);
-
-		rd_kafka_message_destroy(rkm);
+		dispatch_message(args, rkm);
 	}
 	pthread_exit(NULL);
 }
@@ -382,67 +503,199 @@ int main(int argc, char **argv)
 	const char *groupid;     /* Argument: Consumer group id */
 	char **topics;           /* Argument: list of topics to subscribe to */
 	int topic_cnt;           /* Number of topics to subscribe to */
+	KAFKA_OPTIONS kafka_options = { 0 }; /* Option: consumer start-up behaviour */
+	const char *metrics_path = NULL;     /* Option: file the metrics are exported to */
+	HANDOFF_POLICY handoff_policy = HANDOFF_LATEST; /* Option: which waiting messages are kept */
+	int handoff_high_watermark = HANDOFF_HIGH_WATERMARK; /* Option: pause fetching at this many messages per render interval */
+	int columns = CHART_COLUMNS;         /* Option: samples shown across the chart width */
+	int log_view = 0;                    /* Option: scrolling log of messages instead of the animated screen */
+	const char *font_path = NULL;        /* Option: PSF2 font the message is drawn with */
+	int show_freshness = 0;              /* Option: draw the p99 produce-to-glass latency */
+	int show_stats = 0;                  /* Option: draw consumer lag and broker round trip time */
+	int use_reactor = 0;                 /* Option: single-threaded event loop instead of a consumer thread */
+	long idle_after_ms = IDLE_AFTER_MS;  /* Option: time without messages until the display goes idle */
+	long idle_frame_ms = IDLE_FRAME_MS;  /* Option: frame interval while idle */
+	int idle_freeze = 0;                 /* Option: stop the stars while idle */
+	int color_depth = 16;                /* Option: 8 bit RGB332 framebuffer instead of RGB565 */
+	IDLE idle;
+	REACTOR reactor;
+	const char *replay_path = NULL;      /* Option: message log consumed instead of Kafka */
+	int replay_realtime = 0;
+	int opt;
+
+	long start_ms = get_monotonic_time_ms();
+	kafka_options.history = 1;
+
+	while ((opt = getopt(argc, argv, "Fn:L:m:w:C:q:c:lf:i:Z8PS:DEr:y:Y:")) != -1) {
+		switch (opt) {
+		case 'F': kafka_options.fast_start = 1; break;
+		case 'n': kafka_options.history = atol(optarg); break;
+		case 'L': kafka_options.max_lag = atol(optarg); break;
+		case 'm': metrics_path = optarg; break;
+		case 'w': kafka_options.workers = atoi(optarg); break;
+		case 'C':
+			if (strcmp(optarg, "key") == 0) handoff_policy = HANDOFF_LATEST_PER_KEY;
+			else if (strcmp(optarg, "all") == 0) handoff_policy = HANDOFF_ALL;
+			else handoff_policy = HANDOFF_LATEST;
+			break;
+		case 'q': handoff_high_watermark = atoi(optarg); break;
+		case 'c': columns = atoi(optarg); break;
+		case 'l': log_view = 1; break;
+		case 'f': font_path = optarg; break;
+		case 'i':
+			if (sscanf(optarg, "%ld:%ld", &idle_after_ms, &idle_frame_ms) < 1 || idle_after_ms < 0 || idle_frame_ms < 1) argc = 0;
+			break;
+		case 'Z': idle_freeze = 1; break;
+		case '8': color_depth = 8; break;
+		case 'P': show_freshness = 1; break;
+		case 'S': kafka_options.statistics_interval_ms = atoi(optarg); break;
+		case 'D': show_stats = 1; break;
+		case 'E': use_reactor = 1; break;
+		case 'r': kafka_options.record_path = optarg; break;
+		case 'y': replay_path = optarg; replay_realtime = 1; break;
+		case 'Y': replay_path = optarg; replay_realtime = 0; break;
+		default: argc = 0; break;
+		}
+	}
+
+	/* The on-screen readout needs statistics */
+	if (show_stats && kafka_options.statistics_interval_ms <= 0)
+		kafka_options.statistics_interval_ms = STATS_INTERVAL_MS;
 
 	/*
 	 * Program argument validation
 	 */
-	if (argc < 4)
+	if (argc - optind < (replay_path ? 0 : 3) || columns < 2 || columns > HISTORY_CAPACITY)
 	{
 		fprintf(stderr,
 				"%% Usage: "
-				"%s <broker> <group.id> <topic1> <topic2>..\n",
-				argv[0]);
+				"%s [-F] [-n history] [-L max_lag] [-m metrics_file] [-w workers] [-C latest|key|all] [-q high_watermark] [-c columns] [-l] [-f font_file] [-i idle_ms[:frame_ms]] [-Z] [-8] [-P] [-S stats_interval_ms] [-D] [-E] [-r log_file] [-y|-Y log_file] <broker> <group.id> <topic1> <topic2>..\n"
+				"  -F  fast start: only replay the last <history> messages of each partition\n"
+				"  -n  messages per partition to replay in fast start mode (default: %ld)\n"
+				"  -L  skip ahead when a partition falls more than <max_lag> messages behind\n"
+				"  -m  periodically export metrics to <metrics_file>\n"
+				"  -w  decode messages on <workers> threads, each owning a set of partitions\n"
+				"  -C  messages kept while waiting to be shown: the latest only, the latest per key or all\n"
+				"  -q  pause fetching when <high_watermark> messages arrive before the renderer takes one (default: %d)\n"
+				"  -c  samples shown across the chart width, up to %d for one per pixel column (default: %d)\n"
+				"  -l  show a scrolling log of the latest messages instead of one message at a time (best with -C all)\n"
+				"  -f  draw the message in UTF-8 with the PSF2 console font <font_file>\n"
+				"  -i  dim the panel and render every <frame_ms> after <idle_ms> without messages, 0 never (default: %d:%d)\n"
+				"  -Z  stop the stars while idle\n"
+				"  -8  draw in 256 colours and send 8 bit RGB332 frames, half the size of RGB565 ones (SSD1331 only)\n"
+				"  -P  show the p99 latency from producing a message to displaying it\n"
+				"  -S  export librdkafka statistics as metrics every <stats_interval_ms>\n"
+				"  -D  show consumer lag and broker round trip time (implies -S %d)\n"
+				"  -E  consume and render from one epoll event loop instead of a consumer thread\n"
+				"  -r  record every consumed message to <log_file>\n"
+				"  -y  replay <log_file> at the recorded pace instead of consuming from Kafka (no broker arguments needed)\n"
+				"  -Y  replay <log_file> as fast as possible under a virtual clock\n"
+				"Messages scroll in full up to %d KB of rasterized text (%d characters of the built-in font), longer ones are cut off.\n",
+				argv[0], 1L, HANDOFF_HIGH_WATERMARK, HISTORY_CAPACITY, CHART_COLUMNS, IDLE_AFTER_MS, IDLE_FRAME_MS, STATS_INTERVAL_MS,
+				MARQUEE_MAX_STRIP_KB, MARQUEE_MAX_STRIP_KB * 1024 / (MARQUEE_SIZE * MARQUEE_SIZE));
 		return 1;
 	}
 
-	brokers   = argv[1];
-	groupid   = argv[2];
-	topics    = &argv[3];
-	topic_cnt = argc - 3;
+	brokers   = argc - optind > 0 ? argv[optind] : NULL;
+	groupid   = argc - optind > 1 ? argv[optind + 1] : NULL;
+	topics    = &argv[optind + 2 < argc ? optind + 2 : argc];
+	topic_cnt = argc - optind > 2 ? argc - optind - 2 : 0;
 
 	long previous_ms = 0, current_ms = 0, elapsed_ms = 0, lag_ms = 0, count_ms = 0;
+	long first_correct_frame_ms = 0;
 	
-	/* Reserve memory for instance struct */
-	INSTANCE *instance = malloc(sizeof *instance);
-	if (!instance || !init(instance)) return -1;
-	
-	/* Initialize Kafka handler and assign pointer to instance struct */
-	instance->kafka_handler = init_kafka_handler(brokers, groupid, topic_cnt, topics);	
-	if (!instance->kafka_handler) {		
-		fprintf(stderr, "Failed to initialize Kafka handler.");
+	/* Glyphs of the font are rasterized when they are first shown */
+	PSF_FONT *font = NULL;
+	if (font_path && !(font = psf_open(font_path))) {
+		fprintf(stderr, "Failed to open PSF2 font %s.\n", font_path);
 		return 1;
 	}
-	
-	previous_ms = get_current_time();
 
-	/* Reserve memory for Kafka message text and make it empty at first */
-	char latest_message_text[20];
-	sprintf(latest_message_text, "%s", "");
+	/* Frames are drawn and sent in the chosen format from the start */
+	if (SSD1331_set_color_depth(color_depth) < 0) {
+		fprintf(stderr, "The %s panel has no 256 colour mode.\n", PANEL_NAME);
+		return 1;
+	}
+
+	/* Reserve memory for instance struct */
+	INSTANCE *instance = malloc(sizeof *instance);
+	if (!instance || !init(instance, columns, font)) return -1;
+	instance->show_freshness = show_freshness;
+	instance->show_stats = show_stats;
+	if (log_view) logview_init(&instance->logview);
 	
-	/* Prepare args for consumer threads - Kafka handler & pointer to latest message text */
+	/* Prepare args for consumer threads - Kafka handler & slot for the latest message */
 	KAFKA_CONSUMER_ARGS *args = malloc(sizeof *args);
+	args->handoff = &instance->handoff;
+	args->accept_utf8 = font != NULL;
+	handoff_init(args->handoff, handoff_policy, handoff_high_watermark, handoff_high_watermark / 4);
+	
+	/* With -w messages are handled on decode workers instead of the consumer thread */
+	kafka_options.handler = handle_message;
+	kafka_options.handler_opaque = args;
+
+	/* Signals are taken over by the event loop before librdkafka starts its threads */
+	if (use_reactor && reactor_init(&reactor, MS_PER_UPDATE_GRAPHICS) < 0) return 1;
+
+	/* Initialize Kafka handler and assign pointer to instance struct, or read messages from a log without one */
+	if (replay_path) {
+		instance->kafka_handler = NULL;
+		if (kafka_start_replay(replay_path, replay_realtime) < 0) {
+			fprintf(stderr, "Failed to open message log %s.\n", replay_path);
+			return 1;
+		}
+	}
+	else {
+		instance->kafka_handler = init_kafka_handler(brokers, groupid, topic_cnt, topics, &kafka_options);
+		if (!instance->kafka_handler) {
+			fprintf(stderr, "Failed to initialize Kafka handler.");
+			return 1;
+		}
+	}
 	args->rk = instance->kafka_handler;
-	args->payload = latest_message_text;
+	instance->handoff.rk = instance->kafka_handler;
 	
-	/* Start thread with message consumer */
+	/* Pacing runs on the monotonic clock, replaying only moves the virtual clock of the event times */
+	previous_ms = get_monotonic_time_ms();
+	idle_init(&idle, idle_after_ms, idle_frame_ms, idle_freeze, previous_ms);
+
+	/* Start thread with message consumer, or let the event loop wake up on new messages */
 	pthread_t consumer_thread;
-	pthread_create(&consumer_thread, NULL, consume_kafka_messages, (void*) args);
+	if (use_reactor) {
+		if (instance->kafka_handler && reactor_watch_kafka(&reactor, instance->kafka_handler) < 0) return 1;
+	}
+	else {
+		pthread_create(&consumer_thread, NULL, consume_kafka_messages, (void*) args);
 
-	/* Stop program on CTRL+c */
-	signal(SIGINT, stop);
+		/* Stop program on CTRL+c */
+		signal(SIGINT, stop);
+	}
 
 	/*
 	 * Main program loop
 	 */
 	while(program_is_running)
 	{
-		current_ms = get_current_time();
+		/* Event loop mode: sleep until messages arrive or the next frame is due.
+		 * The queue is drained on every wakeup, which also keeps polling within max.poll.interval.ms */
+		if (use_reactor) {
+			int events = reactor_wait(&reactor);
+			if (events & REACTOR_STOP) break;
+			consume_available_messages(args);
+			if (!events) continue;
+		}
 
-		/* Update if enough time elapsed */
-		if (count_ms > MS_PER_UPDATE_LOGIC) {
+		current_ms = get_monotonic_time_ms();
 
-			/* Write latest Kafka message */
-			sprintf(instance->debug_info.bottom, "[%s]", latest_message_text);
+		/* Update if enough time elapsed */
+		if (count_ms > MS_PER_UPDATE_LOGIC || (!first_correct_frame_ms && kafka_caught_up())) {
+
+			/* Show the next Kafka message, keep the current one if none is waiting */
+			MESSAGE_REF *next_message = log_view ? NULL : handoff_pop(&instance->handoff);
+			if (next_message) show_message(instance, next_message);
+			if (show_freshness) latency_describe_p99(instance->freshness, sizeof(instance->freshness));
+			if (show_stats) kafka_stats_describe(instance->stats, sizeof(instance->stats));
+			if (metrics_path) metrics_export(metrics_path);
 			count_ms = 0;
 		}
 
@@ -451,16 +704,43 @@ int main(int argc, char **argv)
 		previous_ms = current_ms;
 		count_ms += elapsed_ms;
 		lag_ms += elapsed_ms;
+		marquee_advance(&instance->marquee, elapsed_ms);
+
+		/* Dim the panel and slow down while no messages arrive, the next one brings back the full frame rate */
+		if (idle_update(&idle, current_ms) && use_reactor)
+			reactor_set_tick(&reactor, idle_tick_ms(&idle, MS_PER_UPDATE_GRAPHICS));
+
+		/* The log view only sends new lines, there are no frames to render */
+		if (log_view) {
+			show_logged_messages(instance);
+			if (!use_reactor) usleep(MS_PER_UPDATE_GRAPHICS * 1000);
+			continue;
+		}
+
+		if (!idle_frame_due(&idle, current_ms)) {
+			if (!use_reactor) usleep(MS_PER_UPDATE_GRAPHICS * 1000);
+			continue;
+		}
 
 		/* Update the background according to lag */
+		if (idle.state == IDLE_DIMMED && idle.freeze_background) lag_ms = 0;
 		while (lag_ms >= MS_PER_UPDATE_GRAPHICS) 
 		{
 			if (!update_background(instance, lag_ms)) return -1;
 			lag_ms -= MS_PER_UPDATE_GRAPHICS;
 		}
 
-		/* Render instance state to screen */
+		/* Render instance state to screen, the frame reached the glass once the SPI transfer returned */
+		long long render_us = get_monotonic_time_us();
 		if (!render(instance, lag_ms / (float) MS_PER_UPDATE_GRAPHICS)) return -1;
+		latency_displayed(&instance->pending_trace, render_us, get_monotonic_time_us());
+
+		/* Report how long it took until the screen showed up-to-date values */
+		if (!first_correct_frame_ms && kafka_caught_up()) {
+			first_correct_frame_ms = get_monotonic_time_ms() - start_ms;
+			metrics_set(METRIC_TIME_TO_FIRST_CORRECT_FRAME_MS, first_correct_frame_ms);
+			fprintf(stderr, "%% First up-to-date frame rendered after %ld ms\n", first_correct_frame_ms);
+		}
 	}
 
 	/* Exit program */
@@ -468,9 +748,14 @@ int main(int argc, char **argv)
 	/* Clear and turn off display*/
 	SSD1331_clear();
 	command(DISPLAY_OFF);
+
+	/* Wait for the consumer to stop handing over messages */
+	if (use_reactor) reactor_close(&reactor);
+	else pthread_join(consumer_thread, NULL);
 	
 	/* Free memory */
 	deallocate_instance_from_memory(instance);
+	psf_close(font);
 
 	/* Disable running threads */
 	pthread_exit(NULL);
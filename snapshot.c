@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "snapshot.h"
+
+#define SNAPSHOT_SLOTS 2
+#define SNAPSHOT_CHECKSUM_START offsetof(SNAPSHOT, size)
+
+/**
+ * FNV-1a hash of the snapshot contents following the checksum field.
+ */
+static uint32_t snapshot_checksum(const SNAPSHOT *snapshot)
+{
+	const unsigned char *data = (const unsigned char *) snapshot + SNAPSHOT_CHECKSUM_START;
+	size_t len = sizeof(SNAPSHOT) - SNAPSHOT_CHECKSUM_START;
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static int snapshot_is_valid(const SNAPSHOT *snapshot)
+{
+	return snapshot->magic == SNAPSHOT_MAGIC
+		&& snapshot->version == SNAPSHOT_VERSION
+		&& snapshot->size == sizeof(SNAPSHOT)
+		&& snapshot->device_cnt <= SNAPSHOT_MAX_DEVICES
+		&& snapshot->offset_cnt <= KAFKA_MAX_PARTITIONS
+		&& snapshot->checksum == snapshot_checksum(snapshot);
+}
+
+/**
+ * Open (or create) the snapshot file at the given path and map it into memory.
+ *
+ * @returns pointer to the opened file, or NULL on failure.
+ */
+SNAPSHOT_FILE *snapshot_open(const char *path)
+{
+	size_t size = SNAPSHOT_SLOTS * sizeof(SNAPSHOT);
+	SNAPSHOT_FILE *file = malloc(sizeof *file);
+	if (!file) return NULL;
+
+	file->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (file->fd < 0 || ftruncate(file->fd, size) < 0) {
+		perror("snapshot");
+		if (file->fd >= 0) close(file->fd);
+		free(file);
+		return NULL;
+	}
+
+	file->slots = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+	if (file->slots == MAP_FAILED) {
+		perror("snapshot");
+		close(file->fd);
+		free(file);
+		return NULL;
+	}
+
+	const SNAPSHOT *latest = snapshot_latest(file);
+	file->sequence = latest ? latest->sequence : 0;
+
+	return file;
+}
+
+/**
+ * @returns the newest slot with a valid checksum, or NULL if the file holds no usable snapshot.
+ */
+const SNAPSHOT *snapshot_latest(const SNAPSHOT_FILE *file)
+{
+	const SNAPSHOT *latest = NULL;
+	for (int i = 0; i < SNAPSHOT_SLOTS; i++) {
+		const SNAPSHOT *slot = &file->slots[i];
+		if (snapshot_is_valid(slot) && (!latest || slot->sequence > latest->sequence)) {
+			latest = slot;
+		}
+	}
+	return latest;
+}
+
+/**
+ * Pick the slot that does not hold the latest snapshot and invalidate it, so it can be filled in place.
+ * The devices are cleared, nothing of the slot's previous use is left for the caller to append to.
+ * The caller fills in the devices and offsets and then calls snapshot_commit().
+ */
+SNAPSHOT *snapshot_begin(SNAPSHOT_FILE *file)
+{
+	SNAPSHOT *slot = &file->slots[(file->sequence + 1) % SNAPSHOT_SLOTS];
+	slot->magic = 0;
+	slot->device_cnt = 0;
+	slot->offset_cnt = 0;
+	memset(slot->devices, 0, sizeof(slot->devices));
+	return slot;
+}
+
+/**
+ * Seal the slot returned by snapshot_begin() and write it back to disk. Returns only once the slot
+ * is durable, so offsets stored afterwards never get ahead of it, not even after a power loss.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+int snapshot_commit(SNAPSHOT_FILE *file, SNAPSHOT *slot)
+{
+	slot->version = SNAPSHOT_VERSION;
+	slot->size = sizeof(SNAPSHOT);
+	slot->sequence = ++file->sequence;
+	slot->checksum = snapshot_checksum(slot);
+
+	/* The magic number is written last, a torn slot is never considered valid */
+	__atomic_store_n(&slot->magic, SNAPSHOT_MAGIC, __ATOMIC_RELEASE);
+
+	return msync(file->slots, SNAPSHOT_SLOTS * sizeof(SNAPSHOT), MS_SYNC) == 0 ? 1 : -1;
+}
+
+/**
+ * Flush and unmap the snapshot file.
+ */
+void snapshot_close(SNAPSHOT_FILE *file)
+{
+	msync(file->slots, SNAPSHOT_SLOTS * sizeof(SNAPSHOT), MS_SYNC);
+	munmap(file->slots, SNAPSHOT_SLOTS * sizeof(SNAPSHOT));
+	close(file->fd);
+	free(file);
+}
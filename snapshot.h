@@ -0,0 +1,58 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+#include <stdint.h>
+#include "kafkautils.h"
+#include "rollup.h"
+#include "timeseries.h"
+#include "streamstats.h"
+
+#define SNAPSHOT_MAGIC 0x4F4C4544 // "OLED"
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_MAX_DEVICES 8
+#define SNAPSHOT_HISTORY 96
+
+/**
+ * Display state of a single device as stored in the snapshot.
+ */
+typedef struct SNAPSHOT_DEVICE {
+	char name[16];
+	float temperature;
+	uint32_t history_cnt;
+	float history[SNAPSHOT_HISTORY]; // chart temperatures, newest first
+	ROLLUP rollup;
+	TS_SERIES series;  // open and closed buckets the chart has not taken yet, their samples are covered by the offsets
+	STREAM_STATS stats;
+} SNAPSHOT_DEVICE;
+
+/**
+ * One consistent copy of the display state together with the Kafka offsets it was built from.
+ * The checksum covers everything after the checksum field.
+ */
+typedef struct SNAPSHOT {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t checksum;
+	uint32_t size;
+	uint64_t sequence;
+	uint32_t device_cnt;
+	uint32_t offset_cnt;
+	SNAPSHOT_DEVICE devices[SNAPSHOT_MAX_DEVICES];
+	KAFKA_OFFSET offsets[KAFKA_MAX_PARTITIONS];
+} SNAPSHOT;
+
+/**
+ * Memory-mapped snapshot file. It holds two slots which are written alternately,
+ * so a crash while writing one slot always leaves the other one intact.
+ */
+typedef struct SNAPSHOT_FILE {
+	int fd;
+	SNAPSHOT *slots;
+	uint64_t sequence;
+} SNAPSHOT_FILE;
+
+SNAPSHOT_FILE *snapshot_open(const char *);
+const SNAPSHOT *snapshot_latest(const SNAPSHOT_FILE *);
+SNAPSHOT *snapshot_begin(SNAPSHOT_FILE *);
+int snapshot_commit(SNAPSHOT_FILE *, SNAPSHOT *);
+void snapshot_close(SNAPSHOT_FILE *);
+#endif
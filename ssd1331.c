@@ -17,21 +17,72 @@
 #include <wiringPiSPI.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 #include "ssd1331.h"
 
 #define CHANNEL      0
 
-unsigned char buffer[OLED_WIDTH * OLED_HEIGHT * 2];
+unsigned char buffer[PANEL_FRAME_BYTES];   // RGB565 high byte first, or RGB332 in the first half in 8 bit mode
+static int color_depth = 16;
+
+/**
+ * Quantize an RGB565 colour to RGB332 by keeping the top bits of each channel.
+ */
+static unsigned char rgb332(unsigned short hwColor) {
+    return (hwColor >> 8 & 0xE0) | (hwColor >> 6 & 0x1C) | (hwColor >> 3 & 0x03);
+}
 
 void command(unsigned char cmd) {
     digitalWrite(DC, LOW);
     wiringPiSPIDataRW(CHANNEL, &cmd, 1);
 }
 
+/**
+ * Send a command with its arguments, as commands or as data depending on the panel.
+ */
+static void panel_command(unsigned char cmd, const unsigned char *args, int n) {
+    unsigned char data[8];
+    command(cmd);
+    if(n <= 0) {
+        return;
+    }
+    if(PANEL_ARGS_AS_DATA) {
+        digitalWrite(DC, HIGH);
+    }
+    memcpy(data, args, n);
+    wiringPiSPIDataRW(CHANNEL, data, n);
+}
+
+/**
+ * Address all columns of rows first_row..last_row and get the panel ready to take pixel data.
+ */
+static void set_window(int first_row, int last_row) {
+    const unsigned char columns[] = { 0, OLED_WIDTH - 1 };
+    const unsigned char rows[] = { first_row, last_row };
+    panel_command(SET_COLUMN_ADDRESS, columns, 2);
+    panel_command(SET_ROW_ADDRESS, rows, 2);
+    if(PANEL_WRITE_RAM) {
+        command(PANEL_WRITE_RAM);
+    }
+    digitalWrite(DC, HIGH);
+}
+
+/**
+ * Send a sequence of commands in the format of PANEL_INIT.
+ */
+static void send_sequence(const unsigned char *sequence, size_t len) {
+    for(size_t i = 0; i < len; i += 2 + sequence[i + 1]) {
+        panel_command(sequence[i], &sequence[i + 2], sequence[i + 1]);
+    }
+}
+
 void SSD1331_begin() {
+    static const unsigned char init[] = { PANEL_INIT };
+
     pinMode(RST, OUTPUT);
     pinMode(DC, OUTPUT);
-    wiringPiSPISetup(CHANNEL, 2000000);    //2M
+    wiringPiSPISetup(CHANNEL, PANEL_SPI_HZ);
 
     digitalWrite(RST, HIGH);
     delay(10);
@@ -39,67 +90,99 @@ void SSD1331_begin() {
     delay(10);
     digitalWrite(RST, HIGH);
 
-    command(DISPLAY_OFF);          //Display Off
-    command(SET_CONTRAST_A);       //Set contrast for color A
-    command(0xFF);                     //145 0x91
-    command(SET_CONTRAST_B);       //Set contrast for color B
-    command(0xFF);                     //80 0x50
-    command(SET_CONTRAST_C);       //Set contrast for color C
-    command(0xFF);                     //125 0x7D
-    command(MASTER_CURRENT_CONTROL);//master current control
-    command(0x06);                     //6
-    command(SET_PRECHARGE_SPEED_A);//Set Second Pre-change Speed For ColorA
-    command(0x64);                     //100
-    command(SET_PRECHARGE_SPEED_B);//Set Second Pre-change Speed For ColorB
-    command(0x78);                     //120
-    command(SET_PRECHARGE_SPEED_C);//Set Second Pre-change Speed For ColorC
-    command(0x64);                     //100
-    command(SET_REMAP);            //set remap & data format
-    command(0x72);                     //0x72              
-    command(SET_DISPLAY_START_LINE);//Set display Start Line
-    command(0x0);
-    command(SET_DISPLAY_OFFSET);   //Set display offset
-    command(0x0);
-    command(NORMAL_DISPLAY);       //Set display mode
-    command(SET_MULTIPLEX_RATIO);  //Set multiplex ratio
-    command(0x3F);
-    command(SET_MASTER_CONFIGURE); //Set master configuration
-    command(0x8E);
-    command(POWER_SAVE_MODE);      //Set Power Save Mode
-    command(0x00);                     //0x00
-    command(PHASE_PERIOD_ADJUSTMENT);//phase 1 and 2 period adjustment
-    command(0x31);                     //0x31
-    command(DISPLAY_CLOCK_DIV);    //display clock divider/oscillator frequency
-    command(0xF0);
-    command(SET_PRECHARGE_VOLTAGE);//Set Pre-Change Level
-    command(0x3A);
-    command(SET_V_VOLTAGE);        //Set vcomH
-    command(0x3E);
-    command(DEACTIVE_SCROLLING);   //disable scrolling
-//	command(INVERSE_DISPLAY); // ---- tu moje
-    command(NORMAL_BRIGHTNESS_DISPLAY_ON);//set display on
+    send_sequence(init, sizeof(init));
+    if(color_depth == 8) {
+        const unsigned char remap = PANEL_REMAP_256;
+        panel_command(SET_REMAP, &remap, 1);
+    }
 }
 
-void SSD1331_clear() {
-    int i;
-    for(i = 0; i < sizeof(buffer); i++)
-    {
-        buffer[i] = 0;
+/**
+ * Choose the framebuffer format before SSD1331_begin(): 16 bit RGB565, or 8 bit RGB332 which halves the bytes
+ * sent per frame. Colours are still given in RGB565 everywhere and quantized when they are drawn.
+ *
+ * @returns 1 on success, -1 if the panel has no 256 colour mode.
+ */
+int SSD1331_set_color_depth(int bits) {
+    if(bits != 16 && (bits != 8 || !PANEL_REMAP_256)) {
+        return -1;
+    }
+    color_depth = bits;
+    SSD1331_clear();
+    return 1;
+}
+
+/**
+ * @returns bytes sent to the panel by SSD1331_display().
+ */
+int SSD1331_frame_bytes() {
+    return OLED_WIDTH * OLED_HEIGHT * color_depth / 8;
+}
+
+/**
+ * Dim the panel or bring it back to full brightness. The picture stays, nothing has to be sent again.
+ */
+void SSD1331_dim(int on) {
+    static const unsigned char dim[] = { PANEL_DIM };
+    static const unsigned char bright[] = { PANEL_BRIGHT };
+    if(on) {
+        send_sequence(dim, sizeof(dim));
+    } else {
+        send_sequence(bright, sizeof(bright));
     }
 }
 
+void SSD1331_clear() {
+    memset(buffer, 0, SSD1331_frame_bytes());
+}
+
 void SSD1331_draw_point(int x, int y, unsigned short hwColor) {
     if(x >= OLED_WIDTH || y >= OLED_HEIGHT)
     {
         return;
     }
+    if(color_depth == 8) {
+        buffer[x + y * OLED_WIDTH] = rgb332(hwColor);
+        return;
+    }
     buffer[x * 2 + y * OLED_WIDTH * 2] = hwColor >> 8;
     buffer[x * 2 + y * OLED_WIDTH * 2 + 1] = hwColor;
 }
 
+/**
+ * Fill column x from row y1 to row y2 (inclusive, in any order), clipped to the screen.
+ * Writes the framebuffer directly, one store per pixel without the per-point checks.
+ */
+void SSD1331_vspan(int x, int y1, int y2, unsigned short hwColor) {
+    if(x < 0 || x >= OLED_WIDTH) {
+        return;
+    }
+    if(y1 > y2) {
+        int tmp = y1; y1 = y2; y2 = tmp;
+    }
+    if(y1 < 0) y1 = 0;
+    if(y2 >= OLED_HEIGHT) y2 = OLED_HEIGHT - 1;
+
+    if(color_depth == 8) {
+        unsigned char color = rgb332(hwColor);
+        for(int y = y1; y <= y2; y++) {
+            buffer[x + y * OLED_WIDTH] = color;
+        }
+        return;
+    }
+    unsigned char *pixel = &buffer[x * 2 + y1 * OLED_WIDTH * 2];
+    for(int y = y1; y <= y2; y++, pixel += OLED_WIDTH * 2) {
+        pixel[0] = hwColor >> 8;
+        pixel[1] = hwColor;
+    }
+}
+
 void SSD1331_char1616(unsigned char x, unsigned char y, unsigned char chChar, unsigned short hwColor) {
     unsigned char i, j;
     unsigned char chTemp = 0, y0 = y;
+    if(chChar < '0' || chChar - '0' >= sizeof(Font1612) / sizeof(Font1612[0])) {
+        return;
+    }
     for (i = 0; i < 32; i ++) {
         chTemp = Font1612[chChar - 0x30][i];
         for (j = 0; j < 8; j ++) {
@@ -123,7 +206,8 @@ void SSD1331_char1616(unsigned char x, unsigned char y, unsigned char chChar, un
 static void SSD1331_char53(unsigned char x, unsigned char y, char acsii, char size, char mode, unsigned short hwColor) {
     unsigned char i, j, y0=y;
     int temp;
-    unsigned char ch = acsii - ' ';
+    /* The fonts only cover printable ASCII, anything else would index past them */
+    unsigned char ch = acsii >= ' ' && acsii <= '~' ? acsii - ' ' : '?' - ' ';
     for(i = 0;i<1;i++) {
 		
 		temp = Font0503[ch];
@@ -161,6 +245,9 @@ void SSD1331_string53(unsigned char x, unsigned char y, const char *pString, uns
 void SSD1331_char3216(unsigned char x, unsigned char y, unsigned char chChar, unsigned short hwColor) {
     unsigned char i, j;
     unsigned char chTemp = 0, y0 = y; 
+    if(chChar < '0' || chChar - '0' >= sizeof(Font3216) / sizeof(Font3216[0])) {
+        return;
+    }
 
     for (i = 0; i < 64; i++) {
         chTemp = Font3216[chChar - 0x30][i];
@@ -182,34 +269,78 @@ void SSD1331_char3216(unsigned char x, unsigned char y, unsigned char chChar, un
     }
 }
 
+/**
+ * @returns column `column` of a glyph of the 12 or 16 pixel font, the top row in bit size - 1.
+ */
+static unsigned short font_column(unsigned char ch, int column, char size) {
+    if(size == 12) {
+        const unsigned char *packed = &Font1206[ch][column / 2 * 3];
+        return column & 1 ? (packed[1] & 0x0F) << 8 | packed[2] : packed[0] << 4 | packed[1] >> 4;
+    }
+    return Font1608[ch][column * 2] << 8 | Font1608[ch][column * 2 + 1];
+}
+
 static void SSD1331_char(unsigned char x, unsigned char y, char acsii, char size, char mode, unsigned short hwColor) {
-    unsigned char i, j, y0=y;
-    char temp;
-    unsigned char ch = acsii - ' ';
-    for(i = 0;i<size;i++) {
-        if(size == 12)
-        {
-            if(mode)temp=Font1206[ch][i];
-            else temp = ~Font1206[ch][i];
+    /* The fonts only cover printable ASCII, anything else would index past them */
+    unsigned char ch = acsii >= ' ' && acsii <= '~' ? acsii - ' ' : '?' - ' ';
+    for(int column = 0; column < size / 2; column++, x++) {
+        unsigned short temp = font_column(ch, column, size);
+        if(!mode) temp = ~temp;
+        for(int row = 0; row < size; row++) {
+            if(temp & (1 << (size - 1 - row))) SSD1331_draw_point(x, y + row, hwColor);
+            else SSD1331_draw_point(x, y + row, 0);
         }
-        else 
-        {            
-            if(mode)temp=Font1608[ch][i];
-            else temp = ~Font1608[ch][i];
+    }
+}
+
+/**
+ * Rasterize up to `len` characters into an off-screen strip of `Size` rows and `strip_width` pixels per row,
+ * starting at column x, stored like the framebuffer, so it can be copied to the screen with SSD1331_blit.
+ * Characters outside the font are drawn as '?'. Drawing stops at the first character that does not fit.
+ *
+ * @returns the column after the rasterized text.
+ */
+int SSD1331_text_strip(unsigned char *strip, int strip_width, int x, const char *pString, size_t len, unsigned char Size, unsigned short hwColor) {
+    for (size_t n = 0; n < len && x + Size / 2 <= strip_width; n++, x += Size / 2) {
+        unsigned char ch = pString[n] >= ' ' && pString[n] <= '~' ? pString[n] - ' ' : '?' - ' ';
+        for (int column = 0; column < Size / 2; column++) {
+            unsigned short temp = font_column(ch, column, Size);
+            for (int row = 0; row < Size; row++) {
+                unsigned char *pixel = &strip[(row * strip_width + x + column) * 2];
+                int set = temp & (1 << (Size - 1 - row));
+                pixel[0] = set ? hwColor >> 8 : 0;
+                pixel[1] = set ? hwColor : 0;
+            }
         }
-        for(j =0;j<8;j++)
-        {
-            if(temp & 0x80) SSD1331_draw_point(x, y, hwColor);
-            else SSD1331_draw_point(x, y, 0);
-            temp <<=1;
-            y++;
-            if((y-y0)==size)
-            {
-                y = y0;
-                x ++;
-                break;
+    }
+    return x;
+}
+
+/**
+ * Copy `width` x `height` pixels starting at column src_x of an off-screen strip to the screen at x, y.
+ * Whole rows are copied at once, parts outside the screen are clipped.
+ */
+void SSD1331_blit(int x, int y, const unsigned char *strip, int strip_width, int src_x, int width, int height) {
+    if(x < 0) {
+        src_x -= x;
+        width += x;
+        x = 0;
+    }
+    if(x + width > OLED_WIDTH) width = OLED_WIDTH - x;
+    if(width <= 0) {
+        return;
+    }
+    for(int row = 0; row < height; row++) {
+        if(y + row < 0 || y + row >= OLED_HEIGHT) continue;
+        const unsigned char *src = &strip[(row * strip_width + src_x) * 2];
+        if(color_depth == 8) {
+            unsigned char *dst = &buffer[(y + row) * OLED_WIDTH + x];
+            for(int i = 0; i < width; i++, src += 2) {
+                dst[i] = rgb332(src[0] << 8 | src[1]);
             }
+            continue;
         }
+        memcpy(&buffer[((y + row) * OLED_WIDTH + x) * 2], src, width * 2);
     }
 }
 
@@ -229,6 +360,20 @@ void SSD1331_string(unsigned char x, unsigned char y, const char *pString, unsig
     }
 }
 
+/**
+ * Draw `len` characters of pString on a single line, without requiring a terminating '\0'.
+ * Characters that do not fit on the line are clipped.
+ *
+ * @returns the x position following the last drawn character.
+ */
+int SSD1331_string_n(int x, unsigned char y, const char *pString, size_t len, unsigned char Size, unsigned char Mode, unsigned short hwColor) {
+    for (size_t i = 0; i < len && x <= (OLED_WIDTH - Size / 2); i++) {
+        SSD1331_char(x, y, pString[i], Size, Mode, hwColor);
+        x += Size / 2;
+    }
+    return x;
+}
+
 void SSD1331_mono_bitmap(unsigned char x, unsigned char y, const unsigned char *pBmp, char chWidth, char chHeight, unsigned short hwColor) {
     unsigned char i, j, byteWidth = (chWidth + 7) / 8;
     for(j = 0; j < chHeight; j++) {
@@ -255,8 +400,13 @@ void SSD1331_bitmap24(unsigned char x, unsigned char y, unsigned char *pBmp, cha
         }
     }
 }
+/**
+ * Let the controller draw a line on the panel. Panels without drawing commands get it in the framebuffer instead.
+ */
 void SSD1331_draw_line(int x1, int y1, int x2, int y2, unsigned short hwColor) {
-	
+#if !PANEL_HAS_DRAW_COMMANDS
+    SSD1331_line(x1, y1, x2, y2, hwColor);
+#else
     command(DRAW_LINE);
 	command(x1);
 	command(y1);
@@ -266,6 +416,7 @@ void SSD1331_draw_line(int x1, int y1, int x2, int y2, unsigned short hwColor) {
 	command((hwColor << 8) & 0xFF);
 	command(hwColor & 0xFF);
 	digitalWrite(DC, HIGH);
+#endif
 }
 void SSD1331_line(int xp1, int yp1, int xp2, int yp2, unsigned short hwColor) {
 	int tmp;
@@ -307,15 +458,31 @@ void SSD1331_line(int xp1, int yp1, int xp2, int yp2, unsigned short hwColor) {
 
 void SSD1331_display() {
     int txLen = 512;
-    int remain = sizeof(buffer);
+    int remain = SSD1331_frame_bytes();
 unsigned char *pBuffer = buffer;
-    command(SET_COLUMN_ADDRESS);
-    command(0);         //cloumn start address
-    command(OLED_WIDTH - 1); //cloumn end address
-    command(SET_ROW_ADDRESS);
-    command(0);         //page atart address
-    command(OLED_HEIGHT - 1); //page end address
-    digitalWrite(DC, HIGH);
+    set_window(0, OLED_HEIGHT - 1);
+    while (remain > txLen)
+    {
+        wiringPiSPIDataRW(CHANNEL, pBuffer, txLen);
+        remain -= txLen;
+        pBuffer += txLen;
+    }
+    wiringPiSPIDataRW(CHANNEL, pBuffer, remain);
+}
+
+/**
+ * Send framebuffer rows first_row..first_row + rows - 1 to the same rows of the display RAM.
+ * The rest of the display RAM keeps what was sent before.
+ */
+void SSD1331_display_rows(int first_row, int rows) {
+    if(first_row < 0 || rows <= 0 || first_row + rows > OLED_HEIGHT) {
+        return;
+    }
+    set_window(first_row, first_row + rows - 1);
+
+    int txLen = 512;
+    int remain = rows * OLED_WIDTH * color_depth / 8;
+    unsigned char *pBuffer = &buffer[first_row * OLED_WIDTH * color_depth / 8];
     while (remain > txLen)
     {
         wiringPiSPIDataRW(CHANNEL, pBuffer, txLen);
@@ -325,6 +492,22 @@ unsigned char *pBuffer = buffer;
     wiringPiSPIDataRW(CHANNEL, pBuffer, remain);
 }
 
+/**
+ * Show display RAM row `row` in the top line of the panel, the rows below it follow and wrap around.
+ * Scrolls the whole picture without sending pixel data.
+ */
+void SSD1331_start_line(int row) {
+    const unsigned char line = row & (OLED_HEIGHT - 1);
+    panel_command(SET_DISPLAY_START_LINE, &line, 1);
+}
+
+void SSD1331_clear_rows(int first_row, int rows) {
+    if(first_row < 0 || rows <= 0 || first_row + rows > OLED_HEIGHT) {
+        return;
+    }
+    memset(&buffer[first_row * OLED_WIDTH * color_depth / 8], 0, rows * OLED_WIDTH * color_depth / 8);
+}
+
 void SSD1331_clear_screen(unsigned short hwColor) {
     unsigned short i, j;
     for(i = 0; i < OLED_HEIGHT; i++) {
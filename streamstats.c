@@ -0,0 +1,122 @@
+#include <math.h>
+#include <string.h>
+#include "streamstats.h"
+
+/**
+ * Reset the statistics. The EWMA decays to 1/e of a value's weight after `ewma_tau_ms` of event time,
+ * rates are measured over the STREAM_RATE_WINDOWS given windows.
+ */
+void stream_stats_init(STREAM_STATS *stats, long ewma_tau_ms, const long *rate_windows_ms)
+{
+	memset(stats, 0, sizeof *stats);
+	stats->ewma_tau_ms = ewma_tau_ms > 0 ? ewma_tau_ms : 1;
+	for (int i = 0; i < STREAM_RATE_WINDOWS; i++) {
+		stats->rates[i].window_ms = rate_windows_ms[i] > 0 ? rate_windows_ms[i] : 1;
+	}
+}
+
+/**
+ * Continue statistics saved by a previous run. They are only taken if the EWMA time constant
+ * and the rate windows did not change.
+ *
+ * @returns 1 if the statistics were restored, 0 if they were left as they are.
+ */
+int stream_stats_restore(STREAM_STATS *stats, const STREAM_STATS *saved)
+{
+	if (saved->ewma_tau_ms != stats->ewma_tau_ms) return 0;
+	for (int i = 0; i < STREAM_RATE_WINDOWS; i++) {
+		const STREAM_RATE *rate = &saved->rates[i];
+		if (rate->window_ms != stats->rates[i].window_ms) return 0;
+		if (rate->head < 0 || rate->head >= STREAM_RATE_CHECKPOINTS || rate->count < 0 || rate->count > STREAM_RATE_CHECKPOINTS) return 0;
+	}
+
+	*stats = *saved;
+	return 1;
+}
+
+/**
+ * Store a checkpoint once the newest one is a fraction of the window old; the oldest checkpoint is dropped then.
+ */
+static void rate_add(STREAM_RATE *rate, int64_t timestamp_ms, float value)
+{
+	if (rate->count) {
+		int newest = (rate->head + STREAM_RATE_CHECKPOINTS - 1) % STREAM_RATE_CHECKPOINTS;
+		if (timestamp_ms - rate->times_ms[newest] < rate->window_ms / (STREAM_RATE_CHECKPOINTS - 1)) return;
+	}
+
+	rate->times_ms[rate->head] = timestamp_ms;
+	rate->values[rate->head] = value;
+	rate->head = (rate->head + 1) % STREAM_RATE_CHECKPOINTS;
+	if (rate->count < STREAM_RATE_CHECKPOINTS) rate->count++;
+}
+
+static void sketch_add(STREAM_STATS *stats, float value)
+{
+	int bucket = (int) floorf((value - STREAM_SKETCH_MIN) / STREAM_SKETCH_STEP);
+	if (bucket < 0) bucket = 0;
+	if (bucket >= STREAM_SKETCH_BUCKETS) bucket = STREAM_SKETCH_BUCKETS - 1;
+
+	stats->sketch[bucket]++;
+	if (++stats->sketch_total < STREAM_SKETCH_DECAY) return;
+
+	stats->sketch_total = 0;
+	for (int i = 0; i < STREAM_SKETCH_BUCKETS; i++) {
+		stats->sketch[i] /= 2;
+		stats->sketch_total += stats->sketch[i];
+	}
+}
+
+/**
+ * Add a value with the given event time. Values older than the latest one count into the sketch and maximum,
+ * but do not move the average back in time.
+ */
+void stream_stats_add(STREAM_STATS *stats, int64_t timestamp_ms, float value)
+{
+	if (!stats->has_value) {
+		stats->ewma = stats->max = value;
+		stats->last_ms = timestamp_ms;
+		stats->has_value = 1;
+	} else if (timestamp_ms > stats->last_ms) {
+		float alpha = 1.0f - expf(-(float) (timestamp_ms - stats->last_ms) / stats->ewma_tau_ms);
+		stats->ewma += alpha * (value - stats->ewma);
+		stats->last_ms = timestamp_ms;
+	}
+	if (value > stats->max) stats->max = value;
+	stats->last = value;
+
+	for (int i = 0; i < STREAM_RATE_WINDOWS; i++) {
+		rate_add(&stats->rates[i], stats->last_ms, stats->ewma);
+	}
+	sketch_add(stats, value);
+}
+
+/**
+ * @returns the change of the average per minute over the given rate window, 0 until it spans some time.
+ */
+float stream_stats_rate(const STREAM_STATS *stats, int window)
+{
+	const STREAM_RATE *rate = &stats->rates[window];
+	if (rate->count < 2) return 0;
+
+	int oldest = (rate->head + STREAM_RATE_CHECKPOINTS - rate->count) % STREAM_RATE_CHECKPOINTS;
+	int64_t elapsed_ms = stats->last_ms - rate->times_ms[oldest];
+	if (elapsed_ms <= 0) return 0;
+
+	return (stats->ewma - rate->values[oldest]) * 60000.0f / elapsed_ms;
+}
+
+/**
+ * @returns the value below which the fraction `q` of the sketched values lies, as the middle of its bucket.
+ */
+float stream_stats_quantile(const STREAM_STATS *stats, float q)
+{
+	if (!stats->sketch_total) return stats->last;
+
+	uint32_t rank = (uint32_t) ceilf(q * stats->sketch_total), seen = 0;
+	if (rank < 1) rank = 1;
+	for (int i = 0; i < STREAM_SKETCH_BUCKETS; i++) {
+		seen += stats->sketch[i];
+		if (seen >= rank) return STREAM_SKETCH_MIN + (i + 0.5f) * STREAM_SKETCH_STEP;
+	}
+	return stats->max;
+}
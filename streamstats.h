@@ -0,0 +1,42 @@
+#ifndef _STREAMSTATS_H_
+#define _STREAMSTATS_H_
+#include <stdint.h>
+
+#define STREAM_RATE_WINDOWS 2
+#define STREAM_RATE_CHECKPOINTS 8
+#define STREAM_SKETCH_BUCKETS 256
+#define STREAM_SKETCH_MIN -20.0f  // lower bound of the first sketch bucket
+#define STREAM_SKETCH_STEP 0.5f   // width of a sketch bucket, the sketch covers -20 to 108
+#define STREAM_SKETCH_DECAY 4096  // counts are halved when they add up to this, so recent values weigh more
+
+/**
+ * Smoothed values sampled at fixed intervals, the oldest one is about one window old.
+ */
+typedef struct STREAM_RATE {
+	long window_ms;
+	int64_t times_ms[STREAM_RATE_CHECKPOINTS];
+	float values[STREAM_RATE_CHECKPOINTS];
+	int head, count;
+} STREAM_RATE;
+
+/**
+ * Statistics of one value stream, each updated in O(1) per value (amortized for the sketch decay):
+ * an exponentially weighted moving average, its rate of change over configurable windows,
+ * the maximum and a fixed-bucket histogram sketch for quantiles. Fixed size, about 0.8 KB.
+ */
+typedef struct STREAM_STATS {
+	long ewma_tau_ms;
+	int has_value;
+	int64_t last_ms;
+	float last, ewma, max;
+	STREAM_RATE rates[STREAM_RATE_WINDOWS];
+	uint16_t sketch[STREAM_SKETCH_BUCKETS];
+	uint32_t sketch_total;
+} STREAM_STATS;
+
+void stream_stats_init(STREAM_STATS *, long, const long *);
+int stream_stats_restore(STREAM_STATS *, const STREAM_STATS *);
+void stream_stats_add(STREAM_STATS *, int64_t, float);
+float stream_stats_rate(const STREAM_STATS *, int);
+float stream_stats_quantile(const STREAM_STATS *, float);
+#endif
@@ -8,10 +8,24 @@
 #include <signal.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
 #include <librdkafka/rdkafka.h>
 #include "kafkautils.h"
 #include "ssd1331.h"
 #include "timeops.h"
+#include "metrics.h"
+#include "snapshot.h"
+#include "timeseries.h"
+#include "history.h"
+#include "rollup.h"
+#include "autoscale.h"
+#include "chart.h"
+#include "streamstats.h"
+#include "record.h"
+#include "latency.h"
+#include "kafkastats.h"
+#include "reactor.h"
+#include "idle.h"
 #include "gui.h"
 
 #define SHOW_TOP_DEBUG 0
@@ -19,7 +33,7 @@
 #define BOTTOM_DEBUG_RGB (RGB(60,60,200))
 #define MS_PER_UPDATE_GRAPHICS 16
 #define MS_PER_UPDATE_LOGIC 1000 
-#define AMOUNT_PARTICLES 48
+#define CHART_COLUMNS 48
 #define AMOUNT_STARS 48
 #define AMOUNT_DEVICES 4
 #define TYPE_1_STAR 1
@@ -31,9 +45,16 @@
 #define TYPE_1_STAR_CHANCE 100
 #define TYPE_3_STAR_CHANCE 500
 #define MIN_TEMP_Y 15
-#define MAX_TEMP_Y 53
-#define TEMP_SCALE_MIN 47
-#define TEMP_SCALE_MAX 57 
+#define MAX_TEMP_Y (OLED_HEIGHT - 11)
+#define TEMP_SCALE_STEP 1.0f
+#define TEMP_SCALE_MIN_SPAN 4.0f
+#define MS_PER_SNAPSHOT 5000
+#define MS_PER_BUCKET 5000
+#define STATS_INTERVAL_MS 5000
+#define ZOOM_LEVELS (1 + ROLLUP_TIERS)
+#define EWMA_TAU_MS 60000
+#define RATE_WINDOW_MS 60000
+#define TREND_WINDOW_MS 600000
 
 #define DEVICE_0_KEY "leto"
 #define DEVICE_1_KEY "duncan"
@@ -52,6 +73,34 @@ static void stop (int sig) {
 	program_is_running = 0;
 }
 
+/**
+ * Chart resolution: 0 shows the chart buckets, higher levels the rollup tiers
+ */
+static volatile sig_atomic_t zoom_level = 0;
+
+/**
+ * Switches the charts to the next coarser resolution, wrapping around to the finest
+ */
+static void next_zoom (int sig) {
+	zoom_level = (zoom_level + 1) % ZOOM_LEVELS;
+}
+
+/**
+ * Statistic shown next to the device names
+ */
+typedef enum READOUT {
+	READOUT_LAST,   // latest temperature
+	READOUT_EWMA,   // moving average
+	READOUT_RATE,   // change per minute over the rate window
+	READOUT_TREND,  // change per minute over the trend window
+	READOUT_P50,
+	READOUT_P95,
+	READOUT_MAX,
+	READOUT_COUNT
+} READOUT;
+
+static const char *readout_names[READOUT_COUNT] = { "last", "ewma", "rate", "trend", "p50", "p95", "max" };
+
 /** 
  * Struct describing a particle in the background (stars) 
  */
@@ -65,7 +114,11 @@ typedef struct DEVICE {
 	char name[10];
 	float temperature;
 	unsigned int rgb;
-	PARTICLE *temperature_particles;
+	HISTORY history; // chart samples, one per column
+	MINMAX_WINDOW extremes; // lowest and highest temperature in the chart history
+	ROLLUP rollup;   // closed buckets rolled up to 10 s, 1 min and 1 h for the zoomed out charts
+	STREAM_STATS stats; // running statistics of every received temperature
+	TS_SERIES series; // samples bucketed by event time, each closed bucket advances the chart
 } DEVICE;
 
 typedef struct BACKGROUND {
@@ -74,24 +127,39 @@ typedef struct BACKGROUND {
 
 typedef struct INSTANCE {
 	BACKGROUND *background;
-	PARTICLE *particles;
 	DEVICE *devices;
 	rd_kafka_t *kafka_handler;
 	float temperature;
+	pthread_mutex_t lock; // guards device state against the consumer thread
+	SNAPSHOT_FILE *snapshot;
+	long bucket_ms; // width of a chart column in event time
+	int columns;    // samples shown across the chart width
+	SCALE scale;      // temperature range of the chart, fitted to the histories of all devices
+	SCALE zoom_scale; // temperature range of the zoomed out charts
+	CHART_STYLE chart_style;
+	READOUT readout;
+	long rate_windows_ms[STREAM_RATE_WINDOWS];
+	LATENCY_TRACE pending_trace; // stage timestamps of updates not displayed yet, guarded by lock
+	int show_freshness;          // draw the p99 produce-to-glass latency
+	char freshness[16];
+	int show_stats;              // draw consumer lag and broker round trip time
+	char stats[24];
 } INSTANCE;
 
 typedef struct KAFKA_CONSUMER_ARGS {
 	rd_kafka_t *rk; // pointer to kafka consumer instance
-	char *payload; // the latest message text from the topic will be stored in this pointer
 	DEVICE *devices;
+	pthread_mutex_t *lock; // held while a message is applied to the devices
+	LATENCY_TRACE *pending_trace; // applied updates are folded in here until a frame displayed them
 } KAFKA_CONSUMER_ARGS;
 
 /** 
- * Converts a float to screen y position, determined by float min/max values & oled height 
+ * Converts a float to screen y position, determined by the scale range & oled height 
  */
-static int float_to_screen_y(const float temperature) 
+static int float_to_screen_y(const SCALE *scale, const float temperature) 
 {
-	return 64 - (((temperature - TEMP_SCALE_MIN) / (TEMP_SCALE_MAX - TEMP_SCALE_MIN)) * (MAX_TEMP_Y - MIN_TEMP_Y)) - MIN_TEMP_Y;
+	if (!scale->valid) return OLED_HEIGHT - MIN_TEMP_Y;
+	return OLED_HEIGHT - (((temperature - scale->lo) / (scale->hi - scale->lo)) * (MAX_TEMP_Y - MIN_TEMP_Y)) - MIN_TEMP_Y;
 }
 
 /** 
@@ -151,35 +219,88 @@ int init_devices(DEVICE *devices)
 	devices[1].rgb = colors[1]; //RGB(75, 36, 143); //colors[1]; // 75, 36, 143
 	devices[2].rgb = colors[2]; //RGB(19, 27, 76); //colors[2]; // 19, 27, 76
 	devices[3].rgb = colors[3]; //RGB(0, 243, 197); //RGB(127, 64, 122); //colors[3]; // 0, 243, 197 || 127, 64, 122
-   
-	dev0->temperature_particles = malloc(AMOUNT_PARTICLES * sizeof(PARTICLE)); //dev0particles;
-	dev1->temperature_particles = malloc(AMOUNT_PARTICLES * sizeof(PARTICLE)); // dev1particles;
-	dev2->temperature_particles = malloc(AMOUNT_PARTICLES * sizeof(PARTICLE)); // dev1particles;
-	dev3->temperature_particles = malloc(AMOUNT_PARTICLES * sizeof(PARTICLE)); // dev1particles;
 
 	return 0;
 }
 
 
 /**
- * Update the particles responsible for showing the temperature chart.
- * TODO implement this for each device registering in the kafka alive topic.
+ * Advance the temperature chart of the device by one column showing the given temperature.
  */
-int update_temperature (DEVICE *device, float temperature) 
+int update_temperature (DEVICE *device, const SCALE *scale, float temperature) 
 {
-	PARTICLE *current_temperature;
-	PARTICLE *previous_temperature;
-
-	/* Code responsible for adjusting the line chart when time elapses */
-	for (int i = AMOUNT_PARTICLES - 1; i > 0; i--) {
-		current_temperature = &device->temperature_particles[i];
-		previous_temperature = &device->temperature_particles[i-1];
-		current_temperature->y = previous_temperature->y;
-	}
-	device->temperature_particles[0].y = float_to_screen_y(device->temperature);
+	/* The new sample replaces the oldest one, so the chart scrolls by one column */
+	history_push(&device->history, temperature, float_to_screen_y(scale, temperature));
+	minmax_push(&device->extremes, temperature);
 	
 	return 1;	
 }
+
+/**
+ * Advance the chart of the device by every bucket that closed since the last call.
+ * The chart shows the average of each bucket, so bursts of samples do not distort the line.
+ */
+static int update_device_chart(DEVICE *device, const SCALE *scale, long current_ms)
+{
+	TS_BUCKET bucket;
+
+	ts_advance(&device->series, current_ms);
+	while (ts_pop(&device->series, &bucket)) {
+		if (!update_temperature(device, scale, ts_bucket_avg(&bucket))) return 0;
+		rollup_add(&device->rollup, &bucket);
+		metrics_add(METRIC_CHART_ADVANCES, 1);
+	}
+
+	return 1;
+}
+
+/**
+ * Fit the chart scale to the temperatures in the histories of all devices.
+ * Only when the range changed the stored samples are mapped to new screen positions.
+ */
+static void rescale_charts(INSTANCE *instance)
+{
+	float lo = 0, hi = 0;
+	int has_extremes = 0;
+
+	for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES; dev_idx++) {
+		float min, max;
+		if (!minmax_get(&instance->devices[dev_idx].extremes, &min, &max)) continue;
+		if (!has_extremes || min < lo) lo = min;
+		if (!has_extremes || max > hi) hi = max;
+		has_extremes = 1;
+	}
+	if (!has_extremes || !scale_fit(&instance->scale, lo, hi)) return;
+
+	for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES; dev_idx++) {
+		HISTORY *history = &instance->devices[dev_idx].history;
+		for (int i = 0; i < history->count; i++) {
+			HISTORY_SAMPLE *sample = &history->samples[i];
+			sample->y = float_to_screen_y(&instance->scale, history_sample_value(sample));
+		}
+	}
+}
+
+/**
+ * Fit the scale of the zoomed out charts to the lowest and highest temperature of the points on screen.
+ */
+static void rescale_rollups(INSTANCE *instance, int tier)
+{
+	float lo = 0, hi = 0;
+	int has_extremes = 0;
+
+	for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES; dev_idx++) {
+		ROLLUP_POINT point;
+		for (int i = 0; i < instance->columns && rollup_point(&instance->devices[dev_idx].rollup, tier, i, &point); i++) {
+			if (!point.count) continue;
+			if (!has_extremes || point.min < lo) lo = point.min;
+			if (!has_extremes || point.max > hi) hi = point.max;
+			has_extremes = 1;
+		}
+	}
+	if (has_extremes) scale_fit(&instance->zoom_scale, lo, hi);
+}
+
 /**
  * Initializes the program instance
  */
@@ -195,31 +316,26 @@ int init(INSTANCE *instance)
 	BACKGROUND *background = malloc(sizeof *background);
 	if (!background || !init_background(background)) return -1;
 	
-	/* Allocate memory for stars in the background*/
-	PARTICLE *particles = malloc(AMOUNT_PARTICLES * sizeof *particles);
-	if (!particles) return -1;	
-
 	DEVICE *devices = malloc(AMOUNT_DEVICES * sizeof *devices)	;
 	if (!devices || init_devices(devices)) return -1;
 
 	instance->background = background;
-	instance->particles = particles;
 	instance->devices = devices;
 	instance->temperature = 30.0f;
 
-	/* Place temperature particles in their initial position */
+	/* Start every chart as a flat line at the initial temperature */
 	for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES; dev_idx ++) {
 		DEVICE *device = &instance->devices[dev_idx];
-		for (int i = 0; i < AMOUNT_PARTICLES; i++) {
-			PARTICLE *current_particle = &device->temperature_particles[i];
-			current_particle->x = OLED_WIDTH - i*(OLED_WIDTH/AMOUNT_PARTICLES);
-			current_particle->y = float_to_screen_y(device->temperature);
-			int mod = i * (255 / AMOUNT_PARTICLES);
-			current_particle->rgb = RGB((255-mod),mod,mod);
-			current_particle->type = 0;
-		}	
-		update_temperature(device, device->temperature);
+		if (history_init(&device->history, instance->columns) < 0) return -1;
+		if (minmax_init(&device->extremes, instance->columns) < 0) return -1;
+		for (int i = 0; i < instance->columns; i++) {
+			update_temperature(device, &instance->scale, device->temperature);
+		}
+		ts_init(&device->series, instance->bucket_ms);
+		rollup_init(&device->rollup);
+		stream_stats_init(&device->stats, EWMA_TAU_MS, instance->rate_windows_ms);
 	}
+	rescale_charts(instance);
 
 	/* Turn on the OLED screen */
 	SSD1331_begin();
@@ -265,25 +381,89 @@ static int render_background(const INSTANCE *instance)
 }
 
 /**
- * Draw temperature of the given DEVICE* as a line chart.
+ * Column of the i-th newest of `columns` chart points: the newest at the right edge, the oldest at the left edge.
  */
-static int render_termometer(const DEVICE *device) 
+static int column_to_screen_x(int i, int columns)
 {
-	PARTICLE *current_temperature;
-	PARTICLE *previous_temperature;
-	for (int i = 0; i < AMOUNT_PARTICLES; i++) {
-		current_temperature = &device->temperature_particles[i];
-	    previous_temperature = &device->temperature_particles[i < AMOUNT_PARTICLES - 1 ? i+1 : 0];
-		if (i < AMOUNT_PARTICLES - 1) {
-			SSD1331_line(current_temperature->x, current_temperature->y, 
-						previous_temperature->x, previous_temperature->y, 
-						device->rgb);
+	return OLED_WIDTH - 1 - i * (OLED_WIDTH - 1) / (columns - 1);
+}
+
+/**
+ * Plot a rollup tier of the given DEVICE*: the mean of each point, or its lowest to highest temperature
+ * for an envelope. Points without samples interrupt the plot.
+ */
+static void plot_rollup(CHART_SERIES *series, const DEVICE *device, int tier, int columns, const SCALE *scale, CHART_STYLE style)
+{
+	ROLLUP_POINT point;
+
+	for (int i = 0; i < columns && rollup_point(&device->rollup, tier, i, &point); i++) {
+		int x = column_to_screen_x(i, columns);
+		if (!point.count) {
+			chart_gap(series, x);
+		} else if (style == CHART_ENVELOPE) {
+			chart_point(series, x, float_to_screen_y(scale, point.max), float_to_screen_y(scale, point.min));
+		} else {
+			int y = float_to_screen_y(scale, rollup_point_mean(&point));
+			chart_point(series, x, y, y);
 		}
 	}
+}
+
+/**
+ * Plot the chart history of the given DEVICE*. Its samples hold one temperature, so an envelope is a line.
+ */
+static void plot_termometer(CHART_SERIES *series, const DEVICE *device) 
+{
+	HISTORY_ITER iter;
+	HISTORY_SAMPLE sample;
+	int columns = device->history.capacity;
+
+	history_iter_begin(&iter, &device->history);
+	for (int i = 0; history_iter_next(&iter, &sample); i++) {
+		chart_point(series, column_to_screen_x(i, columns), sample.y, sample.y);
+	}
+}
+
+/**
+ * Draw the temperatures of all devices in one pass over the screen columns.
+ */
+static int render_charts(const INSTANCE *instance, int zoom)
+{
+	CHART chart;
+
+	/* Areas are filled down to the row of the lowest temperature on the scale */
+	chart_init(&chart, instance->chart_style, OLED_HEIGHT - MIN_TEMP_Y);
+	for (int i = 0; i < AMOUNT_DEVICES; i++) {
+		const DEVICE *device = &instance->devices[i];
+		CHART_SERIES *series = chart_add_series(&chart, device->rgb);
+		if (!series) break;
+
+		if (zoom > 0) plot_rollup(series, device, zoom - 1, instance->columns, &instance->zoom_scale, instance->chart_style);
+		else plot_termometer(series, device);
+	}
+	chart_draw(&chart);
 
 	return 1;
 }
 
+/**
+ * Write the device name and the selected statistic of the given DEVICE* to `text`.
+ */
+static void format_readout(char *text, size_t size, const DEVICE *device, READOUT readout)
+{
+	const STREAM_STATS *stats = &device->stats;
+
+	switch (readout) {
+	case READOUT_EWMA: snprintf(text, size, "%s %.1f", device->name, stats->ewma); break;
+	case READOUT_RATE: snprintf(text, size, "%s %+.1f", device->name, stream_stats_rate(stats, 0)); break;
+	case READOUT_TREND: snprintf(text, size, "%s %+.1f", device->name, stream_stats_rate(stats, 1)); break;
+	case READOUT_P50: snprintf(text, size, "%s %.1f", device->name, stream_stats_quantile(stats, 0.50f)); break;
+	case READOUT_P95: snprintf(text, size, "%s %.1f", device->name, stream_stats_quantile(stats, 0.95f)); break;
+	case READOUT_MAX: snprintf(text, size, "%s %.1f", device->name, stats->has_value ? stats->max : device->temperature); break;
+	default: snprintf(text, size, "%s %.1f", device->name, device->temperature); break;
+	}
+}
+
 /**
  * Draw the debug text.
  */
@@ -296,17 +476,30 @@ static int render_debug(const INSTANCE *instance)
 
 	char display_text[15];
 	
-	sprintf(display_text, "%s %.1f", DEVICE_0_KEY, device0->temperature);
+	format_readout(display_text, sizeof(display_text), device0, instance->readout);
 	SSD1331_string53(0, TOP_DEBUG_STRING_Y, display_text, 2, 1, device0->rgb);
 
-	sprintf(display_text, "%s %.1f", DEVICE_1_KEY, device1->temperature);
-	SSD1331_string53(48, TOP_DEBUG_STRING_Y, display_text, 2, 1, device1->rgb);
+	format_readout(display_text, sizeof(display_text), device1, instance->readout);
+	SSD1331_string53(OLED_WIDTH / 2, TOP_DEBUG_STRING_Y, display_text, 2, 1, device1->rgb);
 
-	sprintf(display_text, "%s %.1f", DEVICE_2_KEY, device2->temperature);
+	format_readout(display_text, sizeof(display_text), device2, instance->readout);
 	SSD1331_string53(0, BOTTOM_DEBUG_STRING_Y, display_text, 2, 1, device2->rgb);
 
-	sprintf(display_text, "%s %.1f", DEVICE_3_KEY, device3->temperature);
-	SSD1331_string53(48, BOTTOM_DEBUG_STRING_Y, display_text, 2, 1, device3->rgb);
+	format_readout(display_text, sizeof(display_text), device3, instance->readout);
+	SSD1331_string53(OLED_WIDTH / 2, BOTTOM_DEBUG_STRING_Y, display_text, 2, 1, device3->rgb);
+
+	if (instance->show_stats && instance->stats[0]) {
+		SSD1331_string53(0, STATS_STRING_Y, instance->stats, 2, 1, BOTTOM_DEBUG_RGB);
+	}
+	if (instance->show_freshness && instance->freshness[0]) {
+		int x = OLED_WIDTH - 4 * strlen(instance->freshness);
+		SSD1331_string53(x, FRESHNESS_STRING_Y, instance->freshness, 2, 1, BOTTOM_DEBUG_RGB);
+	}
+	if (zoom_level > 0) {
+		static const char *zoom_labels[ROLLUP_TIERS] = { "10s", "1m", "1h" };
+		const char *label = zoom_labels[zoom_level - 1];
+		SSD1331_string53((OLED_WIDTH - 4 * strlen(label)) / 2, ZOOM_STRING_Y, label, 2, 1, BOTTOM_DEBUG_RGB);
+	}
 
 	return 1;
 }
@@ -319,32 +512,103 @@ int render(const INSTANCE *instance, const float ms)
 	SSD1331_clear();
 
 	render_background(instance);
-	for (int i = 0; i < AMOUNT_DEVICES; i++) {
-		render_termometer(&instance->devices[i]);
-	}
+	render_charts(instance, zoom_level);
 	render_debug(instance);	
 	
 	SSD1331_display();
+	metrics_add(METRIC_FRAMES_RENDERED, 1);
+	metrics_add(METRIC_FRAME_BYTES, SSD1331_frame_bytes());
 	
 	return 1;
 }
 
+/**
+ * Restore device temperatures, chart history, buckets, rollups and statistics from a snapshot.
+ * Devices are matched by name, so a snapshot taken with a different device list is applied partially.
+ */
+static int restore_snapshot(INSTANCE *instance, const SNAPSHOT *snapshot)
+{
+	for (int i = 0; i < snapshot->device_cnt; i++) {
+		const SNAPSHOT_DEVICE *saved = &snapshot->devices[i];
+		for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES; dev_idx++) {
+			DEVICE *device = &instance->devices[dev_idx];
+			if (strncmp(device->name, saved->name, sizeof(saved->name)) != 0) continue;
+
+			device->temperature = saved->temperature;
+			/* Saved newest first, so push from the oldest sample that still fits */
+			int history_cnt = saved->history_cnt < device->history.capacity ? saved->history_cnt : device->history.capacity;
+			for (int p = history_cnt - 1; p >= 0; p--) {
+				update_temperature(device, &instance->scale, saved->history[p]);
+			}
+			device->rollup = saved->rollup;
+			/* Samples of buckets that had not closed are part of the restored offsets and are not consumed again */
+			if (!ts_restore(&device->series, &saved->series))
+				fprintf(stderr, "%% Bucket width changed, open buckets of %s are not restored\n", device->name);
+			stream_stats_restore(&device->stats, &saved->stats);
+		}
+	}
+	fprintf(stderr, "%% Restored snapshot #%llu with %u device(s) and %u partition offset(s)\n",
+			(unsigned long long) snapshot->sequence, snapshot->device_cnt, snapshot->offset_cnt);
+
+	return 1;
+}
+
+/**
+ * Write device state and the offsets it was built from into the next snapshot slot,
+ * then store those offsets so the committed offsets always match a written snapshot.
+ * Every sample up to the offsets is in the snapshot, in the history or in a bucket that has not closed.
+ */
+static int write_snapshot(INSTANCE *instance)
+{
+	SNAPSHOT *snapshot = snapshot_begin(instance->snapshot);
+
+	pthread_mutex_lock(&instance->lock);
+	for (int dev_idx = 0; dev_idx < AMOUNT_DEVICES && dev_idx < SNAPSHOT_MAX_DEVICES; dev_idx++) {
+		const DEVICE *device = &instance->devices[dev_idx];
+		SNAPSHOT_DEVICE *saved = &snapshot->devices[dev_idx];
+
+		snprintf(saved->name, sizeof(saved->name), "%s", device->name);
+		saved->temperature = device->temperature;
+		HISTORY_ITER iter;
+		HISTORY_SAMPLE sample;
+		history_iter_begin(&iter, &device->history);
+		while (saved->history_cnt < SNAPSHOT_HISTORY && history_iter_next(&iter, &sample)) {
+			saved->history[saved->history_cnt++] = history_sample_value(&sample);
+		}
+		saved->rollup = device->rollup;
+		saved->series = device->series;
+		saved->stats = device->stats;
+		snapshot->device_cnt++;
+	}
+	snapshot->offset_cnt = kafka_applied_offsets(snapshot->offsets, KAFKA_MAX_PARTITIONS);
+	pthread_mutex_unlock(&instance->lock);
+
+	if (snapshot_commit(instance->snapshot, snapshot) < 0) return -1;
+	kafka_store_offsets(instance->kafka_handler, snapshot->offsets, snapshot->offset_cnt);
+
+	return 1;
+}
+
 /**
  * Free memory used by program instance.
  */
 int deallocate_instance_from_memory(INSTANCE *instance) 
 {
+	/* Stop the decode workers before the devices they write to and the partition queues go away */
+	kafka_stop_workers();
+
 	free(instance->background->stars);
 	free(instance->background);
-	free(instance->particles);
-	free(instance->devices->temperature_particles);
 	free(instance->devices);
 
-	/* Close the consumer: commit final offsets and leave the group. */
-	fprintf(stderr, "%% Closing consumer\n");
-	rd_kafka_consumer_close(instance->kafka_handler);
-	/* Destroy the consumer */
-	rd_kafka_destroy(instance->kafka_handler);
+	/* Close the consumer: commit final offsets and leave the group. There is none while replaying. */
+	if (instance->kafka_handler) {
+		fprintf(stderr, "%% Closing consumer\n");
+		rd_kafka_consumer_close(instance->kafka_handler);
+		/* Destroy the consumer */
+		rd_kafka_destroy(instance->kafka_handler);
+	}
+	kafka_close_logs();
 
 	free(instance);
 
@@ -357,79 +621,153 @@ int deallocate_instance_from_memory(INSTANCE *instance)
 static int is_printable (const char *buf, size_t size) {
         size_t i;
         for (i = 0 ; i < size ; i++)
-                if (!isprint((int)buf[i]))
+                if (!isprint((unsigned char)buf[i]))
                         return 0;
         return 1;
 }
 
+/**
+ * Handle a single consumed message: parse the temperature and add it to the device it was sent by.
+ * The payload is either a binary record (see record.h) or the temperature as text, with the device name as key.
+ * Runs on the consumer thread, or on a decode worker when started with -w.
+ * Only applying the value is done under the instance lock, decoding runs in parallel.
+ */
+static void handle_message(rd_kafka_t *rk, rd_kafka_message_t *rkm, void *opaque) {
+
+	struct KAFKA_CONSUMER_ARGS *args = (struct KAFKA_CONSUMER_ARGS *) opaque;
+	DEVICE *devices = args->devices;	
+	DEVICE *target = NULL;
+	float temperature = 0;
+	int64_t timestamp_ms = 0;
+	LATENCY_TRACE trace;
+
+	latency_consumed(&trace, rkm);
+
+	/* Proper message. */
+	printf("Message on %s [%"PRId32"] at offset %"PRId64":\n",
+	kafka_message_topic(rkm), rkm->partition,
+		   rkm->offset);
+
+	/* Print the message key. */
+	if (rkm->key && is_printable(rkm->key, rkm->key_len))
+			printf(" Key: %.*s\n",
+				   (int)rkm->key_len, (const char *)rkm->key);
+	else if (rkm->key)
+			printf(" Key: (%d bytes)\n", (int)rkm->key_len);
+
+	/* Print the message value/payload. */
+	const char *device_id = NULL;
+	size_t device_id_len = 0;
+	RECORD record;
+
+	if (rkm->payload && record_is_binary(rkm->payload, rkm->len)) {
+		/* Binary record: device id and event time travel inside the record, the key is a fallback */
+		if (record_decode(rkm->payload, rkm->len, &record) > 0 && record.value_cnt > 0) {
+			printf(" Value: (record v%d, %d value(s))\n", record.version, record.value_cnt);
+			device_id = record.device_len ? record.device : rkm->key;
+			device_id_len = record.device_len ? record.device_len : rkm->key_len;
+			temperature = record_value_float(&record.values[0]);
+			timestamp_ms = record.timestamp_ms;
+		}
+		else
+			printf(" Value: (malformed record, %d bytes)\n", (int)rkm->len);
+	}
+	else if (rkm->key && is_printable(rkm->key, rkm->key_len) && rkm->payload && is_printable(rkm->payload, rkm->len)) {
+		printf(" Value: %.*s\n", (int)rkm->len, (const char *)rkm->payload);
+		char text[16];
+		snprintf(text, sizeof(text), "%.*s", (int)rkm->len, (const char *)rkm->payload);
+		device_id = rkm->key;
+		device_id_len = rkm->key_len;
+		temperature = strtof(text, NULL);
+		timestamp_ms = kafka_message_timestamp(rkm);
+	}
+	else if (rkm->key)
+			printf(" Value: (%d bytes)\n", (int)rkm->len);
+
+	if (device_id) {
+		if (timestamp_ms <= 0) timestamp_ms = get_current_time();
+		for (int i = 0; i < AMOUNT_DEVICES; i++) {
+			DEVICE *device = &devices[i];
+			fprintf(stderr, "KEY:[%.*s] DEV[%s]\n", (int)device_id_len, device_id, device->name);
+			if (strlen(device->name) == device_id_len && memcmp(device->name, device_id, device_id_len) == 0) {
+				target = device;
+			}
+		}
+	}
+
+	pthread_mutex_lock(args->lock);
+	if (target) {
+		target->temperature = temperature;
+		stream_stats_add(&target->stats, timestamp_ms, temperature);
+		if (!ts_add(&target->series, timestamp_ms, temperature)) {
+			metrics_add(METRIC_LATE_SAMPLES, 1);
+		}
+		fprintf(stderr, "[%s]=[%0.1f]\n", target->name, target->temperature);
+		latency_merge(args->pending_trace, &trace);
+	}
+	kafka_track_message(rk, rkm);
+	pthread_mutex_unlock(args->lock);
+
+	kafka_message_destroy(rkm);
+}
+
+/**
+ * Hand a polled message over to handle_message(), consumer errors are only reported.
+ */
+static void dispatch_message(struct KAFKA_CONSUMER_ARGS *args, rd_kafka_message_t *rkm) {
+
+	/* consumer_poll() will return either a proper message
+	 * or a consumer error (rkm->err is set). */
+	if (rkm->err) {
+			/* Consumer errors are generally to be considered
+			 * informational as the consumer will automatically
+			 * try to recover from all types of errors. */
+			fprintf(stderr,
+					"%% Consumer error: %s\n",
+					rd_kafka_message_errstr(rkm));
+			kafka_message_destroy(rkm);
+			return;
+	}
+
+	handle_message(args->rk, rkm, args);
+}
+
+/**
+ * Consume every message waiting in the consumer queue without blocking (event loop mode).
+ */
+static void consume_available_messages(struct KAFKA_CONSUMER_ARGS *args) {
+	rd_kafka_message_t *rkm;
+
+	while ((rkm = kafka_consumer_poll(args->rk, 0)) != NULL)
+		dispatch_message(args, rkm);
+}
+
 /** 
  * Run kafka message consumer in a separate thread.
  *
  * @param args - pointer to a KAFKA_CONSUMER_ARGS struct.
  *
  * The handler *rk inside args needs to be already initialized and subscribed to a topic.
- * The text of the latest received message will be stored under the args->payload pointer.
+ * Received temperatures are stored in the devices under args->devices.
+ * With decode workers this thread only serves rebalances and consumer errors.
  */
 void *consume_kafka_messages(void *vargp) {
 
 	struct KAFKA_CONSUMER_ARGS *args = (struct KAFKA_CONSUMER_ARGS *) vargp;
 	rd_kafka_t *rk = args->rk;
-	DEVICE *devices = args->devices;	
 	signal(SIGINT, stop);
 	
 	while (program_is_running) {
 		rd_kafka_message_t *rkm;
 
-		rkm = rd_kafka_consumer_poll(rk, 100);
+		rkm = kafka_consumer_poll(rk, 100);
 		if (!rkm)
 				continue; /* Timeout: no message within 100ms,
 						   *  try again. This short timeout allows
 						   *  checking for `run` at frequent intervals.
 						   */
 
-		/* consumer_poll() will return either a proper message
-		 * or a consumer error (rkm->err is set). */
-		if (rkm->err) {
-				/* Consumer errors are generally to be considered
-				 * informational as the consumer will automatically
-				 * try to recover from all types of errors. */
-				fprintf(stderr,
-						"%% Consumer error: %s\n",
-						rd_kafka_message_errstr(rkm));
-				rd_kafka_message_destroy(rkm);
-				continue;
-		}
-
-		/* Proper message. */
-		printf("Message on %s [%"PRId32"] at offset %"PRId64":\n",
-		rd_kafka_topic_name(rkm->rkt), rkm->partition,
-			   rkm->offset);
-
-		/* Print the message key. */
-		if (rkm->key && is_printable(rkm->key, rkm->key_len))
-				printf(" Key: %.*s\n",
-					   (int)rkm->key_len, (const char *)rkm->key);
-		else if (rkm->key)
-				printf(" Key: (%d bytes)\n", (int)rkm->key_len);
-
-		/* Print the message value/payload. */
-		if (rkm->key && is_printable(rkm->key, rkm->key_len) && rkm->payload && is_printable(rkm->payload, rkm->len)) {
-			printf(" Value: %.*s\n", (int)rkm->len, (const char *)rkm->payload);
-			char key[10];
-			sprintf(key, "%.*s", (int)rkm->key_len, (const char *)rkm->key);
-			for (int i = 0; i < AMOUNT_DEVICES; i++) {
-				DEVICE *device = &devices[i];
-				fprintf(stderr, "KEY:[%.*s] DEV[%s]\n", (int)rkm->key_len, (const char *)rkm->key, device->name);
-				if (strcmp(device->name, key) == 0) {
-					device->temperature= strtof(rkm->payload, NULL);
-					fprintf(stderr, "[%s]=[%0.1f]\n", device->name, device->temperature);
-				}
-			}
-		}
-		else if (rkm->key)
-				printf(" Value: (%d bytes)\n", (int)rkm->len);
-
-		rd_kafka_message_destroy(rkm);
+		dispatch_message(args, rkm);
 	}
 	pthread_exit(NULL);
 }
@@ -448,89 +786,301 @@ int main(int argc, char **argv)
 	const char *groupid;     /* Argument: Consumer group id */
 	char **topics;           /* Argument: list of topics to subscribe to */
 	int topic_cnt;           /* Number of topics to subscribe to */
+	KAFKA_OPTIONS kafka_options = { 0 }; /* Option: consumer start-up behaviour */
+	const char *metrics_path = NULL;     /* Option: file the metrics are exported to */
+	const char *snapshot_path = NULL;    /* Option: file the display state is persisted to */
+	long bucket_ms = MS_PER_BUCKET;      /* Option: event time covered by a chart column */
+	int columns = CHART_COLUMNS;         /* Option: samples shown across the chart width */
+	int zoom = 0;                        /* Option: initial chart resolution */
+	float scale_lo = 0, scale_hi = 0;    /* Option: fixed chart temperature range instead of fitting it */
+	CHART_STYLE chart_style = CHART_LINE; /* Option: how the temperatures are plotted */
+	READOUT readout = READOUT_LAST;      /* Option: statistic shown next to the device names */
+	long rate_windows_ms[STREAM_RATE_WINDOWS] = { RATE_WINDOW_MS, TREND_WINDOW_MS }; /* Option: windows of the change rates */
+	int show_freshness = 0;              /* Option: draw the p99 produce-to-glass latency */
+	int show_stats = 0;                  /* Option: draw consumer lag and broker round trip time */
+	int use_reactor = 0;                 /* Option: single-threaded event loop instead of a consumer thread */
+	long idle_after_ms = IDLE_AFTER_MS;  /* Option: time without messages until the display goes idle */
+	long idle_frame_ms = IDLE_FRAME_MS;  /* Option: frame interval while idle */
+	int idle_freeze = 0;                 /* Option: stop the stars while idle */
+	int color_depth = 16;                /* Option: 8 bit RGB332 framebuffer instead of RGB565 */
+	IDLE idle;
+	REACTOR reactor;
+	const char *replay_path = NULL;      /* Option: message log consumed instead of Kafka */
+	int replay_realtime = 0;
+	KAFKA_OFFSET restored_offsets[KAFKA_MAX_PARTITIONS];
+	int opt;
+
+	long start_ms = get_monotonic_time_ms();
+	kafka_options.history = CHART_COLUMNS * AMOUNT_DEVICES;
+
+	while ((opt = getopt(argc, argv, "Fn:L:m:s:b:c:z:T:g:V:R:w:i:Z8PS:DEr:y:Y:")) != -1) {
+		switch (opt) {
+		case 'F': kafka_options.fast_start = 1; break;
+		case 'n': kafka_options.history = atol(optarg); break;
+		case 'L': kafka_options.max_lag = atol(optarg); break;
+		case 'm': metrics_path = optarg; break;
+		case 'w': kafka_options.workers = atoi(optarg); break;
+		case 's': snapshot_path = optarg; break;
+		case 'b': bucket_ms = atol(optarg); break;
+		case 'c': columns = atoi(optarg); break;
+		case 'z': zoom = atoi(optarg); break;
+		case 'g':
+			if (strcmp(optarg, "area") == 0) chart_style = CHART_AREA;
+			else if (strcmp(optarg, "envelope") == 0) chart_style = CHART_ENVELOPE;
+			else chart_style = CHART_LINE;
+			break;
+		case 'V':
+			for (readout = 0; readout < READOUT_COUNT && strcmp(optarg, readout_names[readout]) != 0; readout++);
+			if (readout == READOUT_COUNT) argc = 0;
+			break;
+		case 'R':
+			if (sscanf(optarg, "%ld:%ld", &rate_windows_ms[0], &rate_windows_ms[1]) != 2) argc = 0;
+			break;
+		case 'T':
+			if (sscanf(optarg, "%f:%f", &scale_lo, &scale_hi) != 2 || scale_hi <= scale_lo) argc = 0;
+			break;
+		case 'i':
+			if (sscanf(optarg, "%ld:%ld", &idle_after_ms, &idle_frame_ms) < 1 || idle_after_ms < 0 || idle_frame_ms < 1) argc = 0;
+			break;
+		case 'Z': idle_freeze = 1; break;
+		case '8': color_depth = 8; break;
+		case 'P': show_freshness = 1; break;
+		case 'S': kafka_options.statistics_interval_ms = atoi(optarg); break;
+		case 'D': show_stats = 1; break;
+		case 'E': use_reactor = 1; break;
+		case 'r': kafka_options.record_path = optarg; break;
+		case 'y': replay_path = optarg; replay_realtime = 1; break;
+		case 'Y': replay_path = optarg; replay_realtime = 0; break;
+		default: argc = 0; break;
+		}
+	}
+
+	/* The on-screen readout needs statistics */
+	if (show_stats && kafka_options.statistics_interval_ms <= 0)
+		kafka_options.statistics_interval_ms = STATS_INTERVAL_MS;
 
 	/*
 	 * Program argument validation
 	 */
-	if (argc < 4)
+	if (argc - optind < (replay_path ? 0 : 3) || columns < 2 || columns > HISTORY_CAPACITY || zoom < 0 || zoom >= ZOOM_LEVELS)
 	{
 		fprintf(stderr,
 				"%% Usage: "
-				"%s <broker> <group.id> <topic1> <topic2>..\n",
-				argv[0]);
+				"%s [-F] [-n history] [-L max_lag] [-m metrics_file] [-w workers] [-s snapshot_file] [-b bucket_ms] [-c columns] [-z zoom] [-T min:max] [-g line|area|envelope] [-V readout] [-R rate_ms:trend_ms] [-i idle_ms[:frame_ms]] [-Z] [-8] [-P] [-S stats_interval_ms] [-D] [-E] [-r log_file] [-y|-Y log_file] <broker> <group.id> <topic1> <topic2>..\n"
+				"  -F  fast start: only replay the last <history> messages of each partition\n"
+				"  -n  messages per partition to replay in fast start mode (default: %ld)\n"
+				"  -L  skip ahead when a partition falls more than <max_lag> messages behind\n"
+				"  -m  periodically export metrics to <metrics_file>\n"
+				"  -w  decode messages on <workers> threads, each owning a set of partitions\n"
+				"  -s  restore display state from <snapshot_file> and periodically save it there\n"
+				"  -b  event time in ms covered by one chart column (default: %d)\n"
+				"  -c  samples shown across the chart width, up to %d for one per pixel column (default: %d)\n"
+				"  -z  initial chart resolution: 0 chart buckets, 1 10 s, 2 1 min, 3 1 h; SIGUSR1 switches to the next one\n"
+				"  -T  fixed chart temperature range, e.g. 47:57 (default: fitted to the temperatures on screen)\n"
+				"  -g  plot style: line, area filled below the line, or envelope from lowest to highest value of zoomed out points\n"
+				"  -V  statistic next to the device names: last, ewma, rate, trend (change per minute), p50, p95 or max\n"
+				"  -R  windows in ms the rate and trend are measured over (default: %d:%d)\n"
+				"  -i  dim the panel and render every <frame_ms> after <idle_ms> without messages, 0 never (default: %d:%d)\n"
+				"  -Z  stop the stars while idle\n"
+				"  -8  draw in 256 colours and send 8 bit RGB332 frames, half the size of RGB565 ones (SSD1331 only)\n"
+				"  -P  show the p99 latency from producing a message to displaying it\n"
+				"  -S  export librdkafka statistics as metrics every <stats_interval_ms>\n"
+				"  -D  show consumer lag and broker round trip time (implies -S %d)\n"
+				"  -E  consume and render from one epoll event loop instead of a consumer thread\n"
+				"  -r  record every consumed message to <log_file>\n"
+				"  -y  replay <log_file> at the recorded pace instead of consuming from Kafka (no broker arguments needed)\n"
+				"  -Y  replay <log_file> as fast as possible under a virtual clock\n",
+				argv[0], (long)(CHART_COLUMNS * AMOUNT_DEVICES), MS_PER_BUCKET, HISTORY_CAPACITY, CHART_COLUMNS, RATE_WINDOW_MS, TREND_WINDOW_MS, IDLE_AFTER_MS, IDLE_FRAME_MS, STATS_INTERVAL_MS);
 		return 1;
 	}
 
-	brokers   = argv[1];
-	groupid   = argv[2];
-	topics    = &argv[3];
-	topic_cnt = argc - 3;
+	brokers   = argc - optind > 0 ? argv[optind] : NULL;
+	groupid   = argc - optind > 1 ? argv[optind + 1] : NULL;
+	topics    = &argv[optind + 2 < argc ? optind + 2 : argc];
+	topic_cnt = argc - optind > 2 ? argc - optind - 2 : 0;
 
 	long previous_ms = 0, current_ms = 0, elapsed_ms = 0, lag_ms = 0, count_ms = 0;
+	long first_correct_frame_ms = 0, snapshot_ms = 0;
 	
-	/* Reserve memory for instance struct */
-	INSTANCE *instance = malloc(sizeof *instance);
-	if (!instance || !init(instance)) return -1;
-	
-	/* Initialize Kafka handler and assign pointer to instance struct */
-	instance->kafka_handler = init_kafka_handler(brokers, groupid, topic_cnt, topics);	
-	if (!instance->kafka_handler) {		
-		fprintf(stderr, "Failed to initialize Kafka handler.");
+	/* Frames are drawn and sent in the chosen format from the start */
+	if (SSD1331_set_color_depth(color_depth) < 0) {
+		fprintf(stderr, "The %s panel has no 256 colour mode.\n", PANEL_NAME);
 		return 1;
 	}
-	
-	previous_ms = get_current_time();
 
-	/* Reserve memory for Kafka message text and make it empty at first */
-	char latest_message_text[20];
-	sprintf(latest_message_text, "%s", "");
+	/* Reserve memory for instance struct */
+	INSTANCE *instance = malloc(sizeof *instance);
+	if (!instance) return -1;
+	instance->bucket_ms = bucket_ms;
+	instance->columns = columns;
+	instance->chart_style = chart_style;
+	instance->readout = readout;
+	memcpy(instance->rate_windows_ms, rate_windows_ms, sizeof(rate_windows_ms));
+	scale_init(&instance->scale, TEMP_SCALE_STEP, TEMP_SCALE_MIN_SPAN);
+	scale_init(&instance->zoom_scale, TEMP_SCALE_STEP, TEMP_SCALE_MIN_SPAN);
+	if (scale_hi > scale_lo) {
+		scale_fix(&instance->scale, scale_lo, scale_hi);
+		scale_fix(&instance->zoom_scale, scale_lo, scale_hi);
+	}
+	zoom_level = zoom;
+	if (!init(instance)) return -1;
+	pthread_mutex_init(&instance->lock, NULL);
+	instance->snapshot = NULL;
+	instance->pending_trace.produced_us = 0;
+	instance->pending_trace.consumed_us = 0;
+	instance->show_freshness = show_freshness;
+	instance->freshness[0] = '\0';
+	instance->show_stats = show_stats;
+	instance->stats[0] = '\0';
+
+	/* Restore the previous display state before connecting, and resume consuming right after it */
+	if (snapshot_path) {
+		instance->snapshot = snapshot_open(snapshot_path);
+		if (!instance->snapshot) {
+			fprintf(stderr, "Failed to open snapshot file %s.\n", snapshot_path);
+			return 1;
+		}
+		const SNAPSHOT *snapshot = snapshot_latest(instance->snapshot);
+		if (snapshot) {
+			restore_snapshot(instance, snapshot);
+			rescale_charts(instance);
+			memcpy(restored_offsets, snapshot->offsets, snapshot->offset_cnt * sizeof(KAFKA_OFFSET));
+			kafka_options.initial_offsets = restored_offsets;
+			kafka_options.initial_offset_cnt = snapshot->offset_cnt;
+		}
+		kafka_options.manual_offset_store = 1;
+	}
 	
-	/* Prepare args for consumer threads - Kafka handler & pointer to latest message text */
+	/* Prepare args for consumer threads - Kafka handler & the devices messages are applied to */
 	KAFKA_CONSUMER_ARGS *args = malloc(sizeof *args);
-	args->rk = instance->kafka_handler;
-	args->payload = latest_message_text;
 	args->devices = instance->devices;
+	args->lock = &instance->lock;
+	args->pending_trace = &instance->pending_trace;
 	
-	/* Start thread with message consumer */
+	/* With -w messages are handled on decode workers instead of the consumer thread */
+	kafka_options.handler = handle_message;
+	kafka_options.handler_opaque = args;
+
+	/* Signals are taken over by the event loop before librdkafka starts its threads */
+	if (use_reactor && reactor_init(&reactor, MS_PER_UPDATE_GRAPHICS) < 0) return 1;
+
+	/* Initialize Kafka handler and assign pointer to instance struct, or read messages from a log without one */
+	if (replay_path) {
+		instance->kafka_handler = NULL;
+		if (kafka_start_replay(replay_path, replay_realtime) < 0) {
+			fprintf(stderr, "Failed to open message log %s.\n", replay_path);
+			return 1;
+		}
+	}
+	else {
+		instance->kafka_handler = init_kafka_handler(brokers, groupid, topic_cnt, topics, &kafka_options);
+		if (!instance->kafka_handler) {
+			fprintf(stderr, "Failed to initialize Kafka handler.");
+			return 1;
+		}
+	}
+	args->rk = instance->kafka_handler;
+	
+	/* Pacing runs on the monotonic clock, replaying only moves the virtual clock of the event times */
+	previous_ms = get_monotonic_time_ms();
+	idle_init(&idle, idle_after_ms, idle_frame_ms, idle_freeze, previous_ms);
+
+	/* Start thread with message consumer, or let the event loop wake up on new messages */
+	/* Zoom the charts in and out with SIGUSR1 */
+	signal(SIGUSR1, next_zoom);
+
 	pthread_t consumer_thread;
-	pthread_create(&consumer_thread, NULL, consume_kafka_messages, (void*) args);
+	if (use_reactor) {
+		if (instance->kafka_handler && reactor_watch_kafka(&reactor, instance->kafka_handler) < 0) return 1;
+	}
+	else {
+		pthread_create(&consumer_thread, NULL, consume_kafka_messages, (void*) args);
 
-	/* Stop program on CTRL+c */
-	signal(SIGINT, stop);
+		/* Stop program on CTRL+c */
+		signal(SIGINT, stop);
+	}
 
 	/*
 	 * Main program loop
 	 */
 	while(program_is_running)
 	{
-		current_ms = get_current_time();
+		/* Event loop mode: sleep until messages arrive or the next frame is due.
+		 * The queue is drained on every wakeup, which also keeps polling within max.poll.interval.ms */
+		if (use_reactor) {
+			int events = reactor_wait(&reactor);
+			if (events & REACTOR_STOP) break;
+			consume_available_messages(args);
+			if (!events) continue;
+		}
+
+		current_ms = get_monotonic_time_ms();
 
 		/* Update if enough time elapsed */
 		if (count_ms > MS_PER_UPDATE_LOGIC) {
 
-			/* Write latest Kafka message */
-			//sprintf(instance->debug_info.bottom, "[%s]", latest_message_text);
+			if (show_freshness) latency_describe_p99(instance->freshness, sizeof(instance->freshness));
+			if (show_stats) kafka_stats_describe(instance->stats, sizeof(instance->stats));
+			if (metrics_path) metrics_export(metrics_path);
 			count_ms = 0;
 		}
 
+		/* Persist the display state */
+		if (instance->snapshot && current_ms - snapshot_ms >= MS_PER_SNAPSHOT) {
+			write_snapshot(instance);
+			snapshot_ms = current_ms;
+		}
+
 		/* FPS calculations */
 		elapsed_ms = current_ms - previous_ms;
 		previous_ms = current_ms;
 		count_ms += elapsed_ms;
 		lag_ms += elapsed_ms;
+
+		/* Advance the charts only when buckets close, not on every frame */
+		pthread_mutex_lock(&instance->lock);
 		for (int i = 0; i < AMOUNT_DEVICES; i++) {
 			DEVICE *device = &instance->devices[i];
-			if (!update_temperature(device, 10.0f)) return -1;
+			if (!update_device_chart(device, &instance->scale, current_ms)) return -1;
+		}
+		rescale_charts(instance);
+		if (zoom_level > 0) rescale_rollups(instance, zoom_level - 1);
+		LATENCY_TRACE frame_trace = instance->pending_trace;
+		instance->pending_trace.produced_us = 0;
+		instance->pending_trace.consumed_us = 0;
+		pthread_mutex_unlock(&instance->lock);
+
+		/* Dim the panel and slow down while no messages arrive, the next one brings back the full frame rate */
+		if (idle_update(&idle, current_ms) && use_reactor)
+			reactor_set_tick(&reactor, idle_tick_ms(&idle, MS_PER_UPDATE_GRAPHICS));
+		if (!idle_frame_due(&idle, current_ms)) {
+			/* Keep the latency samples for the frame that shows them */
+			pthread_mutex_lock(&instance->lock);
+			latency_merge(&instance->pending_trace, &frame_trace);
+			pthread_mutex_unlock(&instance->lock);
+			if (!use_reactor) usleep(MS_PER_UPDATE_GRAPHICS * 1000);
+			continue;
 		}
+
 		/* Update the background according to lag */
+		if (idle.state == IDLE_DIMMED && idle.freeze_background) lag_ms = 0;
 		while (lag_ms >= MS_PER_UPDATE_GRAPHICS) 
 		{
 			if (!update_background(instance, lag_ms)) return -1;
 			lag_ms -= MS_PER_UPDATE_GRAPHICS;
 		}
 
-		/* Render instance state to screen */
+		/* Render instance state to screen, the frame reached the glass once the SPI transfer returned */
+		long long render_us = get_monotonic_time_us();
 		if (!render(instance, lag_ms / (float) MS_PER_UPDATE_GRAPHICS)) return -1;
+		latency_displayed(&frame_trace, render_us, get_monotonic_time_us());
+
+		/* Report how long it took until the screen showed up-to-date values */
+		if (!first_correct_frame_ms && kafka_caught_up()) {
+			first_correct_frame_ms = get_monotonic_time_ms() - start_ms;
+			metrics_set(METRIC_TIME_TO_FIRST_CORRECT_FRAME_MS, first_correct_frame_ms);
+			fprintf(stderr, "%% First up-to-date frame rendered after %ld ms\n", first_correct_frame_ms);
+		}
 	}
 
 	/* Exit program */
@@ -538,6 +1088,15 @@ int main(int argc, char **argv)
 	/* Clear and turn off display*/
 	SSD1331_clear();
 	command(DISPLAY_OFF);
+
+	/* Save the final state once the consumer and its decode workers stopped applying messages */
+	if (use_reactor) reactor_close(&reactor);
+	else pthread_join(consumer_thread, NULL);
+	kafka_stop_workers();
+	if (instance->snapshot) {
+		write_snapshot(instance);
+		snapshot_close(instance->snapshot);
+	}
 	
 	/* Free memory */
 	deallocate_instance_from_memory(instance);
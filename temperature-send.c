@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <librdkafka/rdkafka.h>
+#include "timeops.h"
+#include "metrics.h"
+#include "record.h"
+
+/*
+ * Sends the CPU temperature of this device to a Kafka topic as a device_id->temperature key-value pair.
+ * Replaces temperature-send.py: the temperature is read straight from sysfs and messages are batched
+ * by librdkafka instead of being flushed one by one.
+ */
+
+#define THERMAL_ZONE_PATH "/sys/class/thermal/thermal_zone0/temp"
+#define MS_PER_SAMPLE 5000
+#define MS_PER_REPORT 60000
+#define LINGER_MS "100"
+#define COMPRESSION_CODEC "lz4"
+#define FLUSH_TIMEOUT_MS 10000
+
+/**
+ * Delivery statistics collected in the delivery report callback since the last report.
+ */
+typedef struct DELIVERY_STATS {
+	long delivered;
+	long failed;
+	long latency_sum_us;
+	long latency_max_us;
+} DELIVERY_STATS;
+
+/**
+ * Global variable determining if main loop should run
+ */
+static volatile sig_atomic_t program_is_running = 1;
+
+/**
+ * Stops the program from running
+ */
+static void stop (int sig) {
+	program_is_running = 0;
+}
+
+/**
+ * Reads the temperature in millidegrees Celsius from a sysfs thermal zone.
+ * The file stays open; it is re-read from the start on every sample.
+ *
+ * @returns 1 on success, -1 on failure.
+ */
+static int read_temperature(int fd, long *millidegrees) {
+	char text[16];
+	ssize_t len = pread(fd, text, sizeof(text) - 1, 0);
+	if (len <= 0) return -1;
+	text[len] = '\0';
+
+	char *end;
+	*millidegrees = strtol(text, &end, 10);
+	return end == text ? -1 : 1;
+}
+
+/**
+ * Delivery report callback, called from rd_kafka_poll() once per message when it was
+ * acknowledged by the broker or finally failed.
+ */
+static void delivery_report(rd_kafka_t *rk, const rd_kafka_message_t *rkm, void *opaque) {
+	DELIVERY_STATS *stats = (DELIVERY_STATS*) opaque;
+
+	if (rkm->err) {
+		fprintf(stderr, "%% Message delivery failed: %s\n", rd_kafka_err2str(rkm->err));
+		stats->failed++;
+		metrics_add(METRIC_DELIVERY_FAILURES, 1);
+		return;
+	}
+
+	long latency_us = (long) rd_kafka_message_latency(rkm);
+	if (latency_us < 0) latency_us = 0;
+	stats->delivered++;
+	stats->latency_sum_us += latency_us;
+	if (latency_us > stats->latency_max_us) stats->latency_max_us = latency_us;
+	metrics_add(METRIC_MESSAGES_PRODUCED, 1);
+}
+
+/**
+ * Prints the delivery statistics of the last period, publishes them as metrics and starts a new period.
+ */
+static void report_delivery_stats(DELIVERY_STATS *stats) {
+	long avg_us = stats->delivered ? stats->latency_sum_us / stats->delivered : 0;
+
+	fprintf(stderr, "%% Delivered %ld, failed %ld, latency avg %ld us, max %ld us\n",
+			stats->delivered, stats->failed, avg_us, stats->latency_max_us);
+	metrics_set(METRIC_DELIVERY_LATENCY_AVG_US, avg_us);
+	metrics_set(METRIC_DELIVERY_LATENCY_MAX_US, stats->latency_max_us);
+	memset(stats, 0, sizeof(*stats));
+}
+
+/**
+ * Creates the producer. Messages linger for a while so they are sent in compressed batches,
+ * and idempotence keeps retries from duplicating or reordering them.
+ *
+ * @returns producer instance or NULL on failure.
+ */
+static rd_kafka_t *init_producer(const char *brokers, const char *linger_ms, const char *compression, DELIVERY_STATS *stats) {
+	char errstr[512];
+	const char *settings[][2] = {
+		{ "bootstrap.servers", brokers },
+		{ "linger.ms", linger_ms },
+		{ "compression.type", compression },
+		{ "enable.idempotence", "true" },
+	};
+
+	rd_kafka_conf_t *conf = rd_kafka_conf_new();
+	for (size_t i = 0 ; i < sizeof(settings) / sizeof(settings[0]) ; i++) {
+		if (rd_kafka_conf_set(conf, settings[i][0], settings[i][1],
+					errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+			fprintf(stderr, "%s\n", errstr);
+			rd_kafka_conf_destroy(conf);
+			return NULL;
+		}
+	}
+	rd_kafka_conf_set_dr_msg_cb(conf, delivery_report);
+	rd_kafka_conf_set_opaque(conf, stats);
+
+	rd_kafka_t *rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr, sizeof(errstr));
+	if (!rk) {
+		fprintf(stderr, "%% Failed to create new producer: %s\n", errstr);
+		return NULL;
+	}
+	return rk;
+}
+
+/**
+ * Queues one temperature sample, either as text in degrees or as a binary record in millidegrees.
+ *
+ * @returns 1 if the message was queued, -1 if it was dropped.
+ */
+static int send_temperature(rd_kafka_t *rk, const char *topic, const char *device_id, long millidegrees, long timestamp_ms, int binary) {
+	unsigned char value[RECORD_HEADER_LEN + RECORD_MAX_DEVICE_LEN + RECORD_VALUE_LEN];
+	size_t len;
+
+	if (binary) {
+		RECORD_VALUE temperature = { .type = RECORD_MILLI, .i32 = (int32_t) millidegrees };
+		len = record_encode(value, sizeof(value), device_id, timestamp_ms, &temperature, 1);
+		if (!len) return -1;
+	} else {
+		len = snprintf((char*) value, sizeof(value), "%.1f", millidegrees / 1000.0f);
+	}
+
+	rd_kafka_resp_err_t err = rd_kafka_producev(rk,
+			RD_KAFKA_V_TOPIC(topic),
+			RD_KAFKA_V_KEY(device_id, strlen(device_id)),
+			RD_KAFKA_V_VALUE(value, len),
+			RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+			RD_KAFKA_V_TIMESTAMP(timestamp_ms),
+			RD_KAFKA_V_END);
+	if (err) {
+		/* The local queue is full while the broker is unreachable: drop the sample rather than block sampling */
+		fprintf(stderr, "%% Failed to produce to topic %s: %s\n", topic, rd_kafka_err2str(err));
+		metrics_add(METRIC_SAMPLES_DROPPED, 1);
+		return -1;
+	}
+	return 1;
+}
+
+int main(int argc, char **argv) {
+	const char *brokers, *topic, *device_id;
+	const char *thermal_path = THERMAL_ZONE_PATH;  /* Option: sysfs file holding the temperature */
+	const char *metrics_path = NULL;               /* Option: file the metrics are exported to */
+	const char *linger_ms = LINGER_MS;             /* Option: time messages are held back for batching */
+	const char *compression = COMPRESSION_CODEC;   /* Option: batch compression codec */
+	long sample_ms = MS_PER_SAMPLE;                /* Option: sampling interval */
+	int binary = 0;                                /* Option: send binary records instead of text */
+	DELIVERY_STATS stats = { 0 };
+	int opt;
+
+	while ((opt = getopt(argc, argv, "Bi:l:z:t:m:")) != -1) {
+		switch (opt) {
+		case 'B': binary = 1; break;
+		case 'i': sample_ms = atol(optarg); break;
+		case 'l': linger_ms = optarg; break;
+		case 'z': compression = optarg; break;
+		case 't': thermal_path = optarg; break;
+		case 'm': metrics_path = optarg; break;
+		default: argc = 0; break;
+		}
+	}
+
+	/*
+	 * Program argument validation
+	 */
+	if (argc - optind != 3 || sample_ms < 1)
+	{
+		fprintf(stderr,
+				"%% Usage: "
+				"%s [-B] [-i interval_ms] [-l linger_ms] [-z codec] [-t thermal_file] [-m metrics_file] <broker> <topic> <device_id>\n"
+				"  -B  send binary records (see record.h) instead of text\n"
+				"  -i  sampling interval in ms (default: %d)\n"
+				"  -l  time in ms messages are held back to be sent in batches (default: %s)\n"
+				"  -z  compression codec: none, gzip, snappy, lz4 or zstd (default: %s)\n"
+				"  -t  file the temperature in millidegrees is read from (default: %s)\n"
+				"  -m  periodically export metrics to <metrics_file>\n",
+				argv[0], MS_PER_SAMPLE, LINGER_MS, COMPRESSION_CODEC, THERMAL_ZONE_PATH);
+		return 1;
+	}
+
+	brokers   = argv[optind];
+	topic     = argv[optind + 1];
+	device_id = argv[optind + 2];
+
+	int thermal_fd = open(thermal_path, O_RDONLY);
+	if (thermal_fd < 0) {
+		fprintf(stderr, "Failed to open %s.\n", thermal_path);
+		return 1;
+	}
+
+	rd_kafka_t *rk = init_producer(brokers, linger_ms, compression, &stats);
+	if (!rk) {
+		close(thermal_fd);
+		return 1;
+	}
+
+	/* Stop program on CTRL+c */
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	long next_sample_ms = get_current_time();
+	long next_report_ms = next_sample_ms + MS_PER_REPORT;
+
+	/*
+	 * Main program loop: take a sample, then serve delivery reports until the next one is due
+	 */
+	while (program_is_running)
+	{
+		long current_ms = get_current_time();
+
+		if (current_ms >= next_sample_ms) {
+			long millidegrees;
+			if (read_temperature(thermal_fd, &millidegrees) == 1)
+				send_temperature(rk, topic, device_id, millidegrees, current_ms, binary);
+			else
+				fprintf(stderr, "Failed to read %s.\n", thermal_path);
+
+			/* Keep to the sampling grid; skip missed samples instead of sending them in a burst */
+			next_sample_ms += sample_ms;
+			if (next_sample_ms <= current_ms)
+				next_sample_ms = current_ms + sample_ms;
+		}
+
+		if (current_ms >= next_report_ms) {
+			report_delivery_stats(&stats);
+			if (metrics_path) metrics_export(metrics_path);
+			next_report_ms = current_ms + MS_PER_REPORT;
+		}
+
+		long wait_ms = next_sample_ms - get_current_time();
+		rd_kafka_poll(rk, wait_ms > 0 ? (int) wait_ms : 0);
+	}
+
+	/* Deliver whatever is still lingering in the queue */
+	fprintf(stderr, "%% Flushing %d message(s)\n", rd_kafka_outq_len(rk));
+	rd_kafka_flush(rk, FLUSH_TIMEOUT_MS);
+	if (rd_kafka_outq_len(rk) > 0)
+		fprintf(stderr, "%% %d message(s) were not delivered\n", rd_kafka_outq_len(rk));
+	report_delivery_stats(&stats);
+	if (metrics_path) metrics_export(metrics_path);
+
+	rd_kafka_destroy(rk);
+	close(thermal_fd);
+	return 0;
+}
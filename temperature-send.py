@@ -1,21 +1,35 @@
 import sys
 import os
 import time
+import struct
 from kafka import KafkaProducer
 
 # USAGE:
-# python3 ./temperature-send.py host:port kafka-topic device_id
+# python3 ./temperature-send.py host:port kafka-topic device_id [--binary]
 # 
 # Messages are sent to the kafka broker residing at host:port with topic kafka-topic
 # They are being formatted as a key-value pair consisting of device_id->temperature
+# With --binary the value is a binary record (see record.h) instead of text
 # 
 # @author patryk.szczypien@gmail.com
 
 
+RECORD_MAGIC = 0xB7
+RECORD_VERSION = 1
+RECORD_F32 = 1
+
+
+def encode_record(device_id, temperature):
+    # Header: magic, version, value count, device id length, event time in ms (little-endian)
+    device_bytes = bytes(device_id, encoding='utf-8')[:32]
+    header = struct.pack('<BBBBQ', RECORD_MAGIC, RECORD_VERSION, 1, len(device_bytes), int(time.time() * 1000))
+    return header + device_bytes + struct.pack('<Bf', RECORD_F32, float(temperature))
+
+
 def publish_message(producer_instance, topic_name, key, value):
     try:
         key_bytes = bytes(key, encoding='utf-8')
-        value_bytes = bytes(value, encoding='utf-8')
+        value_bytes = value if isinstance(value, bytes) else bytes(value, encoding='utf-8')
         producer_instance.send(topic_name, key=key_bytes, value=value_bytes)
         producer_instance.flush()
         print('Message published successfully.')
@@ -38,10 +52,10 @@ def connect_kafka_producer(server):
 def getCPUtemperature():
     res = os.popen('vcgencmd measure_temp').readline()
     return(res.replace("temp=","").replace("'C\n",""))
-if len(sys.argv) != 4:
+if len(sys.argv) not in (4, 5) or (len(sys.argv) == 5 and sys.argv[4] != '--binary'):
     print ("""
 USAGE:
-   python3 ./temperature-send.py host:port kafka-topic device_id
+   python3 ./temperature-send.py host:port kafka-topic device_id [--binary]
 """)
     sys.exit()
 
@@ -50,11 +64,13 @@ print (getCPUtemperature());
 server = sys.argv[1]
 topic = sys.argv[2]
 host_key = sys.argv[3]
+binary = len(sys.argv) == 5
 producer = connect_kafka_producer(server)
 
 try:
     while True:
-        publish_message(producer, topic, host_key, getCPUtemperature())
+        temperature = getCPUtemperature()
+        publish_message(producer, topic, host_key, encode_record(host_key, temperature) if binary else temperature)
         time.sleep(5)
 except KeyboardInterrupt:
         print('Manual break by user')
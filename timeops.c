@@ -0,0 +1,53 @@
+#include <sys/time.h>
+#include <time.h>
+#include <stddef.h>
+#include "timeops.h"
+
+/* Virtual clock used when replaying recorded messages, see shift_current_time() and freeze_current_time() */
+static long clock_offset_ms = 0;
+static unsigned long frozen_ms = 0;
+
+/**
+ * Returns the current wall-clock time in milliseconds, or the virtual time while replaying.
+ */
+unsigned long get_current_time(void) {
+	unsigned long frozen = __atomic_load_n(&frozen_ms, __ATOMIC_RELAXED);
+	if (frozen) return frozen;
+
+	struct timeval te; 
+	gettimeofday(&te, NULL); // get current time
+	long milliseconds = te.tv_sec*1000LL + te.tv_usec/1000; // calculate milliseconds
+	return milliseconds + __atomic_load_n(&clock_offset_ms, __ATOMIC_RELAXED);
+}
+
+/**
+ * Let get_current_time() run offset_ms ahead of (or, when negative, behind) the wall clock.
+ */
+void shift_current_time(long offset_ms) {
+	__atomic_store_n(&clock_offset_ms, offset_ms, __ATOMIC_RELAXED);
+}
+
+/**
+ * Stop get_current_time() at now_ms until it is frozen at another time. 0 lets the clock run again.
+ */
+void freeze_current_time(unsigned long now_ms) {
+	__atomic_store_n(&frozen_ms, now_ms, __ATOMIC_RELAXED);
+}
+
+/**
+ * Returns microseconds on a clock that never jumps, e.g. when the wall clock is adjusted.
+ * Only differences between two values are meaningful.
+ */
+long long get_monotonic_time_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * Returns milliseconds on the monotonic clock. Frames, logic updates and metrics are paced with it,
+ * it keeps running while replaying under a shifted or frozen virtual clock.
+ */
+long get_monotonic_time_ms(void) {
+	return (long) (get_monotonic_time_us() / 1000);
+}
@@ -1,9 +1,8 @@
 #ifndef _TIMEOPS_H_
 #define _TIMEOPS_H_
-unsigned long get_current_time(void) {
-	struct timeval te; 
-	gettimeofday(&te, NULL); // get current time
-	long milliseconds = te.tv_sec*1000LL + te.tv_usec/1000; // calculate milliseconds
-	return milliseconds;
-}
+unsigned long get_current_time(void);
+long long get_monotonic_time_us(void);
+long get_monotonic_time_ms(void);
+void shift_current_time(long);
+void freeze_current_time(unsigned long);
 #endif
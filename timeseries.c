@@ -0,0 +1,152 @@
+#include <string.h>
+#include "timeseries.h"
+
+void ts_init(TS_SERIES *series, long width_ms)
+{
+	memset(series, 0, sizeof *series);
+	series->width_ms = width_ms > 0 ? width_ms : 1;
+}
+
+static int64_t bucket_start(const TS_SERIES *series, int64_t timestamp_ms)
+{
+	return timestamp_ms - timestamp_ms % series->width_ms;
+}
+
+static void open_bucket(TS_SERIES *series, int64_t start_ms, float carried)
+{
+	TS_BUCKET *bucket = &series->current;
+	bucket->start_ms = start_ms;
+	bucket->min = bucket->max = bucket->last = carried;
+	bucket->sum = 0;
+	bucket->count = 0;
+	series->has_current = 1;
+}
+
+/**
+ * Queue the open bucket as closed. When the queue is full the oldest closed bucket is dropped.
+ */
+static void close_bucket(TS_SERIES *series)
+{
+	if (series->pending_cnt == TS_MAX_PENDING) {
+		series->pending_head = (series->pending_head + 1) % TS_MAX_PENDING;
+		series->pending_cnt--;
+	}
+	series->pending[(series->pending_head + series->pending_cnt) % TS_MAX_PENDING] = series->current;
+	series->pending_cnt++;
+}
+
+/**
+ * Close the open bucket and every empty bucket until the one starting at `start_ms`, which becomes the open one.
+ * Gaps longer than the queue are shortened, they would scroll the chart past its width anyway.
+ */
+static void roll_to(TS_SERIES *series, int64_t start_ms)
+{
+	float last = series->current.last;
+	int64_t next = series->current.start_ms + series->width_ms;
+
+	close_bucket(series);
+	if ((start_ms - next) / series->width_ms > TS_MAX_PENDING - 1) {
+		next = start_ms - (TS_MAX_PENDING - 1) * series->width_ms;
+	}
+	for (; next < start_ms; next += series->width_ms) {
+		open_bucket(series, next, last);
+		close_bucket(series);
+	}
+	open_bucket(series, start_ms, last);
+}
+
+/**
+ * Add a sample with the given event time.
+ * A sample older than the open bucket can no longer change the chart and is counted into the open bucket.
+ *
+ * @returns 1 if the sample was on time, 0 if it arrived late.
+ */
+int ts_add(TS_SERIES *series, int64_t timestamp_ms, float value)
+{
+	int64_t start_ms = bucket_start(series, timestamp_ms);
+	int on_time = 1;
+
+	if (!series->has_current || timestamp_ms > series->watermark_ms) {
+		series->watermark_ms = timestamp_ms;
+		series->watermark_moved = 1;
+	}
+	if (!series->has_current) {
+		open_bucket(series, start_ms, value);
+	} else if (start_ms > series->current.start_ms) {
+		roll_to(series, start_ms);
+	} else if (start_ms < series->current.start_ms) {
+		on_time = 0;
+	}
+
+	TS_BUCKET *bucket = &series->current;
+	if (bucket->count == 0 || value < bucket->min) bucket->min = value;
+	if (bucket->count == 0 || value > bucket->max) bucket->max = value;
+	bucket->sum += value;
+	bucket->last = value;
+	bucket->count++;
+
+	return on_time;
+}
+
+/**
+ * Close the open bucket once event time passed its end by one bucket width of grace time.
+ * Event time stands at the watermark while samples arrive, however old they are, and runs on
+ * with `now_ms` from the moment the watermark stopped moving, so the chart keeps moving when
+ * samples stop arriving. `now_ms` only has to be steady, its offset to event time does not matter.
+ *
+ * @returns the amount of closed buckets waiting to be taken.
+ */
+int ts_advance(TS_SERIES *series, int64_t now_ms)
+{
+	if (series->has_current) {
+		if (series->watermark_moved) {
+			series->watermark_moved = 0;
+			series->watermark_seen_ms = now_ms;
+		}
+		int64_t silent_ms = now_ms > series->watermark_seen_ms ? now_ms - series->watermark_seen_ms : 0;
+		int64_t due_ms = bucket_start(series, series->watermark_ms + silent_ms) - series->width_ms;
+		if (due_ms > series->current.start_ms) {
+			roll_to(series, due_ms);
+		}
+	}
+	return series->pending_cnt;
+}
+
+/**
+ * Continue a series saved by a previous run, open and closed buckets included.
+ * The saved series is only taken if it uses the same bucket width. Its clock reading belongs
+ * to the previous run, so the watermark counts as just seen.
+ *
+ * @returns 1 if the series was restored, 0 if it was left as it is.
+ */
+int ts_restore(TS_SERIES *series, const TS_SERIES *saved)
+{
+	if (saved->width_ms != series->width_ms) return 0;
+	if (saved->pending_cnt < 0 || saved->pending_cnt > TS_MAX_PENDING) return 0;
+	if (saved->pending_head < 0 || saved->pending_head >= TS_MAX_PENDING) return 0;
+
+	*series = *saved;
+	series->watermark_moved = 1;
+	return 1;
+}
+
+/**
+ * Take the oldest closed bucket.
+ *
+ * @returns 1 if a bucket was written to `bucket`, 0 if none was waiting.
+ */
+int ts_pop(TS_SERIES *series, TS_BUCKET *bucket)
+{
+	if (series->pending_cnt == 0) return 0;
+
+	*bucket = series->pending[series->pending_head];
+	series->pending_head = (series->pending_head + 1) % TS_MAX_PENDING;
+	series->pending_cnt--;
+
+	return 1;
+}
+
+float ts_bucket_avg(const TS_BUCKET *bucket)
+{
+	return bucket->count ? bucket->sum / bucket->count : bucket->last;
+}
@@ -0,0 +1,40 @@
+#ifndef _TIMESERIES_H_
+#define _TIMESERIES_H_
+#include <stdint.h>
+
+#define TS_MAX_PENDING 96 // closed buckets kept until the chart takes them, a full chart width after a fast start
+
+/**
+ * Aggregate of all samples whose event time falls into [start_ms, start_ms + width).
+ * A bucket without samples (count == 0) carries the last value of its predecessor.
+ */
+typedef struct TS_BUCKET {
+	int64_t start_ms;
+	float min, max, sum, last;
+	uint32_t count;
+} TS_BUCKET;
+
+/**
+ * Fixed-width event-time buckets of a single value stream.
+ * Samples are added to the open bucket, closed buckets queue up until the chart takes them.
+ * Buckets close as the watermark, the latest event time seen, moves on. Only while no samples
+ * arrive the watermark is carried forward by the caller's clock.
+ */
+typedef struct TS_SERIES {
+	long width_ms;
+	int has_current;
+	TS_BUCKET current;
+	int64_t watermark_ms;      // latest event time added
+	int watermark_moved;       // set by ts_add(), cleared once ts_advance() noted the time
+	int64_t watermark_seen_ms; // caller's clock when ts_advance() first saw the watermark
+	TS_BUCKET pending[TS_MAX_PENDING];
+	int pending_head, pending_cnt;
+} TS_SERIES;
+
+void ts_init(TS_SERIES *, long);
+int ts_add(TS_SERIES *, int64_t, float);
+int ts_advance(TS_SERIES *, int64_t);
+int ts_restore(TS_SERIES *, const TS_SERIES *);
+int ts_pop(TS_SERIES *, TS_BUCKET *);
+float ts_bucket_avg(const TS_BUCKET *);
+#endif
@@ -0,0 +1,48 @@
+#include <stdlib.h>
+#include <time.h>
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+
+/*
+ * Stand-in for the wiringPi library, linked instead of -lwiringPi to run the display programs
+ * without a panel (see the bench target). Pin and SPI calls go nowhere.
+ *
+ * With OLED_MOCK_SPI=realtime in the environment every SPI transfer takes as long as it would
+ * on the wire at the clock speed requested in wiringPiSPISetup().
+ */
+
+static int spi_speed_hz = 0;
+static int spi_realtime = -1;
+
+int wiringPiSetup(void) {
+	return 0;
+}
+
+void pinMode(int pin, int mode) {
+}
+
+void digitalWrite(int pin, int value) {
+}
+
+void delay(unsigned int ms) {
+	struct timespec duration = { .tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L };
+	nanosleep(&duration, NULL);
+}
+
+int wiringPiSPISetup(int channel, int speed) {
+	spi_speed_hz = speed;
+	return channel;
+}
+
+int wiringPiSPIDataRW(int channel, unsigned char *data, int len) {
+	if (spi_realtime < 0) {
+		const char *mode = getenv("OLED_MOCK_SPI");
+		spi_realtime = mode && mode[0] == 'r';
+	}
+	if (spi_realtime && spi_speed_hz > 0) {
+		long ns = (long long) len * 8 * 1000000000LL / spi_speed_hz;
+		struct timespec duration = { .tv_sec = ns / 1000000000L, .tv_nsec = ns % 1000000000L };
+		nanosleep(&duration, NULL);
+	}
+	return len;
+}